@@ -21,6 +21,10 @@
 
 #include "JSON.h"
 
+#include <libdevcore/Assertions.h>
+
+#include <boost/algorithm/string/replace.hpp>
+
 #include <sstream>
 #include <map>
 #include <memory>
@@ -59,6 +63,20 @@ public:
 	}
 };
 
+StreamWriterBuilder const& prettyWriterBuilder()
+{
+	static map<string, string> settings{{"indentation", "  "}};
+	static StreamWriterBuilder writerBuilder(settings);
+	return writerBuilder;
+}
+
+StreamWriterBuilder const& compactWriterBuilder()
+{
+	static map<string, string> settings{{"indentation", ""}};
+	static StreamWriterBuilder writerBuilder(settings);
+	return writerBuilder;
+}
+
 /// Serialise the JSON object (@a _input) with specific builder (@a _builder)
 /// \param _input JSON input string
 /// \param _builder StreamWriterBuilder that is used to create new Json::StreamWriter
@@ -87,16 +105,12 @@ bool parse(Json::CharReaderBuilder& _builder, string const& _input, Json::Value&
 
 string jsonPrettyPrint(Json::Value const& _input)
 {
-	static map<string, string> settings{{"indentation", "  "}};
-	static StreamWriterBuilder writerBuilder(settings);
-	return print(_input, writerBuilder);
+	return print(_input, prettyWriterBuilder());
 }
 
 string jsonCompactPrint(Json::Value const& _input)
 {
-	static map<string, string> settings{{"indentation", ""}};
-	static StreamWriterBuilder writerBuilder(settings);
-	return print(_input, writerBuilder);
+	return print(_input, compactWriterBuilder());
 }
 
 bool jsonParseStrict(string const& _input, Json::Value& _json, string* _errs /* = nullptr */)
@@ -111,4 +125,106 @@ bool jsonParse(string const& _input, Json::Value& _json, string *_errs /* = null
 	return parse(readerBuilder, _input, _json, _errs);
 }
 
+JsonStreamWriter::JsonStreamWriter(ostream& _stream, bool _pretty):
+	m_stream(_stream),
+	m_pretty(_pretty),
+	m_writer((_pretty ? prettyWriterBuilder() : compactWriterBuilder()).newStreamWriter())
+{
+}
+
+void JsonStreamWriter::write(vector<string> const& _path, Json::Value const& _value)
+{
+	assertThrow(!_path.empty(), JSONWriterError, "Empty path.");
+	assertThrow(!m_finished, JSONWriterError, "Document already finished.");
+
+	if (m_levels.empty())
+	{
+		m_stream << "{";
+		m_levels.emplace_back();
+	}
+
+	size_t common = 0;
+	while (common < m_openKeys.size() && common + 1 < _path.size() && m_openKeys[common] == _path[common])
+		common++;
+	while (m_openKeys.size() > common)
+		closeObject();
+	for (size_t i = common; i + 1 < _path.size(); ++i)
+		openObject(_path[i]);
+
+	writeKey(_path.back());
+	if (!m_pretty)
+		m_writer->write(_value, &m_stream);
+	else
+	{
+		// The value is printed as if it were at the top level, where jsoncpp does not start
+		// objects and multi-line arrays on a new line as it does for members, and is indented
+		// to the level of its key. Line breaks in strings are escaped, so this is safe.
+		stringstream value;
+		m_writer->write(_value, &value);
+		string const printed = value.str();
+		if (printed.size() > 1 && printed[1] == '\n')
+			m_stream << "\n" << indentation();
+		m_stream << boost::replace_all_copy(printed, "\n", "\n" + indentation());
+	}
+}
+
+void JsonStreamWriter::finish()
+{
+	assertThrow(!m_finished, JSONWriterError, "Document already finished.");
+	m_finished = true;
+	if (m_levels.empty())
+	{
+		m_stream << "{}";
+		return;
+	}
+	while (!m_openKeys.empty())
+		closeObject();
+	if (m_pretty)
+		m_stream << "\n";
+	m_stream << "}";
+}
+
+void JsonStreamWriter::writeKey(string const& _key)
+{
+	Level& level = m_levels.back();
+	assertThrow(
+		level.empty || level.lastKey < _key,
+		JSONWriterError,
+		"Members have to be written in the order of their keys."
+	);
+	if (!level.empty)
+		m_stream << ",";
+	if (m_pretty)
+		m_stream << "\n" << indentation();
+	m_writer->write(Json::Value(_key), &m_stream);
+	m_stream << (m_pretty ? " : " : ":");
+	level.lastKey = _key;
+	level.empty = false;
+}
+
+void JsonStreamWriter::openObject(string const& _key)
+{
+	writeKey(_key);
+	if (m_pretty)
+		m_stream << "\n" << indentation();
+	m_stream << "{";
+	m_openKeys.push_back(_key);
+	m_levels.emplace_back();
+}
+
+void JsonStreamWriter::closeObject()
+{
+	m_openKeys.pop_back();
+	m_levels.pop_back();
+	if (m_pretty)
+		m_stream << "\n" << indentation();
+	m_stream << "}";
+}
+
+string JsonStreamWriter::indentation() const
+{
+	// Members of the root object are indented once, the braces of the root object not at all.
+	return string(2 * m_levels.size(), ' ');
+}
+
 } // namespace dev
@@ -24,7 +24,12 @@
 
 #include <json/json.h>
 
+#include <boost/noncopyable.hpp>
+
+#include <memory>
+#include <ostream>
 #include <string>
+#include <vector>
 
 namespace dev {
 
@@ -48,4 +53,45 @@ bool jsonParseStrict(std::string const& _input, Json::Value& _json, std::string*
 /// \return \c true if the document was successfully parsed, \c false if an error occurred.
 bool jsonParse(std::string const& _input, Json::Value& _json, std::string* _errs = nullptr);
 
+/// Writes a JSON object to a stream member by member without constructing it in memory.
+/// The result is identical to jsonCompactPrint or jsonPrettyPrint of the complete object.
+/// Members are addressed by their path from the root object, the nested objects on the path
+/// are created implicitly. They have to be written in the order in which jsoncpp sorts
+/// object keys, i.e. bytewise.
+class JsonStreamWriter: boost::noncopyable
+{
+public:
+	explicit JsonStreamWriter(std::ostream& _stream, bool _pretty = false);
+
+	/// Writes @a _value as the member of the root object at @a _path, which must not be empty.
+	void write(std::vector<std::string> const& _path, Json::Value const& _value);
+	/// Closes all open objects. Has to be called once after all members are written.
+	void finish();
+
+	/// @returns true if anything has been written to the stream.
+	bool started() const { return !m_levels.empty(); }
+
+private:
+	/// Keys written so far in the root object and in each open nested object.
+	struct Level
+	{
+		std::string lastKey;
+		bool empty = true;
+	};
+
+	void writeKey(std::string const& _key);
+	void openObject(std::string const& _key);
+	void closeObject();
+	std::string indentation() const;
+
+	std::ostream& m_stream;
+	bool m_pretty = false;
+	bool m_finished = false;
+	std::unique_ptr<Json::StreamWriter> m_writer;
+	/// Keys of the open nested objects.
+	std::vector<std::string> m_openKeys;
+	/// Root object followed by the open nested objects.
+	std::vector<Level> m_levels;
+};
+
 }
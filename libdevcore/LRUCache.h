@@ -0,0 +1,101 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Bounded, thread-safe cache that evicts the least recently used entries.
+ */
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace dev
+{
+
+/**
+ * Map from keys to values that holds at most a given number of entries. If it is full,
+ * storing a new entry evicts the entry that was least recently looked up or stored.
+ * Can be used by multiple threads concurrently.
+ */
+template <class Key, class Value>
+class LRUCache: private boost::noncopyable
+{
+public:
+	explicit LRUCache(size_t _maxEntries): m_maxEntries(_maxEntries) {}
+
+	/// @returns the value stored for @a _key or boost::none if there is none.
+	boost::optional<Value> lookup(Key const& _key)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto it = m_index.find(_key);
+		if (it == m_index.end())
+			return boost::none;
+		m_entries.splice(m_entries.begin(), m_entries, it->second);
+		return it->second->second;
+	}
+
+	/// Stores @a _value for @a _key, replacing the previous value if there is one.
+	void store(Key const& _key, Value _value)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto it = m_index.find(_key);
+		if (it != m_index.end())
+		{
+			it->second->second = std::move(_value);
+			m_entries.splice(m_entries.begin(), m_entries, it->second);
+			return;
+		}
+		if (m_maxEntries == 0)
+			return;
+		if (m_entries.size() >= m_maxEntries)
+		{
+			m_index.erase(m_entries.back().first);
+			m_entries.pop_back();
+		}
+		m_entries.emplace_front(_key, std::move(_value));
+		m_index[_key] = m_entries.begin();
+	}
+
+	size_t size() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_entries.size();
+	}
+
+	void clear()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_index.clear();
+		m_entries.clear();
+	}
+
+private:
+	using Entries = std::list<std::pair<Key, Value>>;
+
+	mutable std::mutex m_mutex;
+	size_t const m_maxEntries;
+	/// The entries, most recently used first.
+	Entries m_entries;
+	std::map<Key, typename Entries::iterator> m_index;
+};
+
+}
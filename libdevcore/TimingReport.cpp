@@ -0,0 +1,195 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Instrumentation for the time and memory spent in the phases of a compilation.
+ */
+
+#include <libdevcore/TimingReport.h>
+
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+using namespace dev;
+
+namespace
+{
+
+thread_local TimingReport* t_currentReport = nullptr;
+thread_local TimingScope* t_currentScope = nullptr;
+
+}
+
+uint64_t& dev::allocationCounter()
+{
+	static thread_local uint64_t counter = 0;
+	return counter;
+}
+
+size_t dev::peakResidentMemory()
+{
+#if defined(_WIN32)
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#if defined(__APPLE__)
+	// Reported in bytes instead of kilobytes.
+	return size_t(usage.ru_maxrss) / 1024;
+#else
+	return size_t(usage.ru_maxrss);
+#endif
+#endif
+}
+
+TimingReport::Activation::Activation(TimingReport* _report):
+	m_previous(t_currentReport)
+{
+	t_currentReport = _report;
+}
+
+TimingReport::Activation::~Activation()
+{
+	t_currentReport = m_previous;
+}
+
+TimingReport* TimingReport::current()
+{
+	return t_currentReport;
+}
+
+void TimingReport::record(
+	string const& _phase,
+	string const& _subject,
+	double _seconds,
+	uint64_t _allocations,
+	size_t _peakMemory
+)
+{
+	lock_guard<mutex> lock(m_mutex);
+	Entry& entry = m_entries[make_pair(_phase, _subject)];
+	entry.calls++;
+	entry.seconds += _seconds;
+	entry.allocations += _allocations;
+	entry.peakMemory = max(entry.peakMemory, _peakMemory);
+}
+
+void TimingReport::count(string const& _phase, string const& _subject, string const& _counter, size_t _amount)
+{
+	lock_guard<mutex> lock(m_mutex);
+	m_entries[make_pair(_phase, _subject)].counters[_counter] += _amount;
+}
+
+void TimingReport::clear()
+{
+	lock_guard<mutex> lock(m_mutex);
+	m_entries.clear();
+}
+
+map<TimingReport::Key, TimingReport::Entry> TimingReport::entries() const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_entries;
+}
+
+Json::Value TimingReport::toJson() const
+{
+	Json::Value report(Json::objectValue);
+	for (auto const& it: entries())
+	{
+		Entry const& entry = it.second;
+		Json::Value measurement(Json::objectValue);
+		measurement["calls"] = Json::UInt64(entry.calls);
+		measurement["seconds"] = entry.seconds;
+		measurement["allocations"] = Json::UInt64(entry.allocations);
+		measurement["processPeakMemoryKiB"] = Json::UInt64(entry.peakMemory);
+		if (!entry.counters.empty())
+		{
+			measurement["counters"] = Json::objectValue;
+			for (auto const& counter: entry.counters)
+				measurement["counters"][counter.first] = Json::UInt64(counter.second);
+		}
+		report[it.first.first][it.first.second] = measurement;
+	}
+	return report;
+}
+
+string TimingReport::toString() const
+{
+	ostringstream out;
+	out << boost::format("%-28s %-40s %6s %12s %12s %25s  %s\n") %
+		"Phase" % "Subject" % "Calls" % "Time (ms)" % "Allocations" % "Process peak so far (KiB)" % "Counters";
+	for (auto const& it: entries())
+	{
+		Entry const& entry = it.second;
+		string counters;
+		for (auto const& counter: entry.counters)
+			counters += (counters.empty() ? "" : ", ") + counter.first + "=" + to_string(counter.second);
+		out << boost::format("%-28s %-40s %6d %12.3f %12d %25d  %s\n") %
+			it.first.first %
+			(it.first.second.empty() ? "*" : it.first.second) %
+			entry.calls %
+			(entry.seconds * 1000) %
+			entry.allocations %
+			entry.peakMemory %
+			counters;
+	}
+	return out.str();
+}
+
+TimingScope::TimingScope(char const* _phase, string const& _subject)
+{
+	m_report = t_currentReport;
+	if (!m_report)
+		return;
+	m_parent = t_currentScope;
+	t_currentScope = this;
+	m_phase = _phase;
+	m_subject = (_subject.empty() && m_parent) ? m_parent->m_subject : _subject;
+	m_allocationsAtStart = allocationCounter();
+	m_start = chrono::steady_clock::now();
+}
+
+TimingScope::~TimingScope()
+{
+	if (!m_report)
+		return;
+	chrono::duration<double> elapsed = chrono::steady_clock::now() - m_start;
+	uint64_t allocations = allocationCounter() - m_allocationsAtStart;
+	t_currentScope = m_parent;
+	m_report->record(m_phase, m_subject, elapsed.count(), allocations, peakResidentMemory());
+}
+
+void TimingScope::count(string const& _counter, size_t _amount)
+{
+	if (m_report)
+		m_report->count(m_phase, m_subject, _counter, _amount);
+}
+
+void TimingScope::countInCurrent(string const& _counter, size_t _amount)
+{
+	if (t_currentReport && t_currentScope)
+		t_currentScope->count(_counter, _amount);
+}
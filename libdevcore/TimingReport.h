@@ -0,0 +1,134 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Instrumentation for the time and memory spent in the phases of a compilation.
+ */
+
+#pragma once
+
+#include <json/json.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace dev
+{
+
+/// @returns the number of heap allocations performed by the current thread so far.
+/// Allocations are only counted if the executable replaces the global operator new and
+/// increments this counter, as solc does. Otherwise, it stays zero.
+uint64_t& allocationCounter();
+
+/// @returns the peak resident set size of the process in KiB or zero if it is not available.
+size_t peakResidentMemory();
+
+/**
+ * Collects the wall time, number of heap allocations and peak memory usage of the phases of
+ * compilations, aggregated per phase and subject (a source or contract name, or empty if the
+ * phase covers all of them), together with named counters (e.g. how often an optimiser pass
+ * changed the code). Measurements are taken by TimingScope objects and recorded in the report
+ * that is active on the current thread. A report can be filled by multiple threads concurrently.
+ */
+class TimingReport: private boost::noncopyable
+{
+public:
+	struct Entry
+	{
+		size_t calls = 0;
+		double seconds = 0;
+		uint64_t allocations = 0;
+		/// Peak resident set size of the whole process in KiB so far, taken at the end of the phase.
+		/// This only grows during the lifetime of the process and includes the memory used by
+		/// other threads, so it is not the memory used by the phase itself.
+		size_t peakMemory = 0;
+		std::map<std::string, size_t> counters;
+	};
+	/// Phase and subject.
+	using Key = std::pair<std::string, std::string>;
+
+	/**
+	 * Makes a report the active one on the current thread for the lifetime of this object.
+	 * Activations can be nested, a null report deactivates the instrumentation.
+	 */
+	class Activation: private boost::noncopyable
+	{
+	public:
+		explicit Activation(TimingReport* _report);
+		~Activation();
+
+	private:
+		TimingReport* m_previous;
+	};
+
+	/// @returns the report that is active on the current thread or nullptr.
+	static TimingReport* current();
+
+	void record(
+		std::string const& _phase,
+		std::string const& _subject,
+		double _seconds,
+		uint64_t _allocations,
+		size_t _peakMemory
+	);
+	void count(std::string const& _phase, std::string const& _subject, std::string const& _counter, size_t _amount);
+	void clear();
+
+	std::map<Key, Entry> entries() const;
+
+	/// @returns the report as a JSON object mapping phases to subjects to their measurements.
+	Json::Value toJson() const;
+	/// @returns the report as a human-readable table.
+	std::string toString() const;
+
+private:
+	mutable std::mutex m_mutex;
+	std::map<Key, Entry> m_entries;
+};
+
+/**
+ * Measures a phase from construction to destruction and records it in the active report.
+ * Does nothing if no report is active on the current thread.
+ * Scopes can be nested, and a scope without subject takes the subject of the enclosing one.
+ */
+class TimingScope: private boost::noncopyable
+{
+public:
+	explicit TimingScope(char const* _phase, std::string const& _subject = std::string());
+	~TimingScope();
+
+	/// Adds @a _amount to the counter @a _counter of this phase.
+	void count(std::string const& _counter, size_t _amount = 1);
+	/// Adds @a _amount to the counter @a _counter of the innermost scope that is active
+	/// on the current thread, if there is one.
+	static void countInCurrent(std::string const& _counter, size_t _amount = 1);
+
+private:
+	TimingReport* m_report = nullptr;
+	TimingScope* m_parent = nullptr;
+	char const* m_phase = nullptr;
+	std::string m_subject;
+	std::chrono::steady_clock::time_point m_start;
+	uint64_t m_allocationsAtStart = 0;
+};
+
+}
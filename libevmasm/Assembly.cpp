@@ -28,14 +28,163 @@
 #include <libevmasm/BlockDeduplicator.h>
 #include <libevmasm/ConstantOptimiser.h>
 #include <libevmasm/GasMeter.h>
+#include <libevmasm/SemanticInformation.h>
+
+#include <libdevcore/TimingReport.h>
 
-#include <fstream>
 #include <json/json.h>
 
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <thread>
+#include <unordered_map>
+
 using namespace std;
 using namespace dev;
 using namespace dev::eth;
 
+namespace
+{
+
+/// @returns a hash of the items in the given range that is compatible with AssemblyItem::operator==.
+size_t blockHash(AssemblyItems::const_iterator _begin, AssemblyItems::const_iterator _end)
+{
+	size_t hash = 0;
+	for (auto it = _begin; it != _end; ++it)
+		boost::hash_combine(hash, hashValue(*it));
+	return hash;
+}
+
+/// @returns true if the jumps in @a _items can only target tags that are pushed in @a _items
+/// itself, which the control flow graph assumes. This is not the case if tags are referenced
+/// from an enclosing assembly, e.g. because the constructor stores internal functions of the
+/// runtime code in storage, or if @a _items pushes the tags of a sub-assembly for that reason.
+bool hasClosedTagSet(AssemblyItems const& _items, set<size_t> const& _tagsReferencedFromOutside)
+{
+	if (!_tagsReferencedFromOutside.empty())
+		return false;
+	return none_of(_items.begin(), _items.end(), [](AssemblyItem const& _item) {
+		return _item.type() == PushTag && _item.splitForeignPushTag().first != size_t(-1);
+	});
+}
+
+/// Optimises @a _items across basic blocks: Removes unreachable blocks, moves blocks behind
+/// their only unconditional jump source and runs the common subexpression eliminator on each
+/// of the resulting blocks.
+/// A block that can only be entered from a single other block starts with the knowledge at the
+/// end of that block, if it was already optimised: A block whose tag is not pushed and that is
+/// entered from the block before it, or a block whose tag is only pushed directly before the
+/// jump at the end of another block. Other blocks start without any knowledge. The state merged
+/// from several predecessors is not used, because it is not reliable enough for code generation.
+/// @returns true if @a _items was changed, which is only done if the code gets shorter.
+bool optimiseControlFlow(AssemblyItems& _items, bool _usesMSize)
+{
+	ControlFlowGraph cfg(_items);
+	BasicBlocks const blocks = cfg.optimisedBlocks();
+
+	map<u256, size_t> pushes;
+	for (BasicBlock const& block: blocks)
+		for (size_t i = block.begin; i < block.end; ++i)
+			if (_items[i].type() == PushTag)
+				pushes[_items[i].data()]++;
+
+	AssemblyItems optimisedItems;
+	// Knowledge at the end of the optimised blocks that jump to a tag pushed only for that jump.
+	map<u256, KnownStatePointer> jumpTargetStates;
+	// Knowledge at the end of the previous block if control flows from there into the next one.
+	KnownStatePointer handedOverState;
+	for (BasicBlock const& block: blocks)
+	{
+		AssemblyItem const& first = _items[block.begin];
+		KnownStatePointer startState;
+		if (first.type() != Tag || !pushes.count(first.data()))
+		{
+			if (block.prev)
+				startState = move(handedOverState);
+		}
+		else if (!block.prev && pushes.at(first.data()) == 1 && jumpTargetStates.count(first.data()))
+			startState = jumpTargetStates.at(first.data());
+		handedOverState.reset();
+
+		CommonSubexpressionEliminator eliminator{startState ? *startState : KnownState()};
+		auto iter = _items.begin() + block.begin;
+		auto const end = _items.begin() + block.end;
+		while (iter != end)
+		{
+			auto orig = iter;
+			iter = eliminator.feedItems(iter, end, _usesMSize);
+			bool shouldReplace = false;
+			AssemblyItems optimisedChunk;
+			try
+			{
+				optimisedChunk = eliminator.getOptimizedItems();
+				shouldReplace = (optimisedChunk.size() < size_t(iter - orig));
+			}
+			catch (OptimizerException const&)
+			{
+				// Keep the original chunk.
+			}
+
+			// The knowledge after the chunk also describes the original items, so it is valid
+			// independent of whether the chunk is replaced.
+			if (shouldReplace)
+				optimisedItems += optimisedChunk;
+			else
+				copy(orig, iter, back_inserter(optimisedItems));
+		}
+
+		if (block.endType == BasicBlock::EndType::HANDOVER || block.endType == BasicBlock::EndType::JUMPI)
+			handedOverState = make_shared<KnownState>(eliminator.state());
+		if (
+			(block.endType == BasicBlock::EndType::JUMP || block.endType == BasicBlock::EndType::JUMPI) &&
+			block.end - block.begin >= 2 &&
+			_items[block.end - 2].type() == PushTag &&
+			pushes.at(_items[block.end - 2].data()) == 1
+		)
+			jumpTargetStates[_items[block.end - 2].data()] = make_shared<KnownState>(eliminator.state());
+	}
+
+	// Blocks whose tag is pushed but never jumped to are removed, so the push would be dangling.
+	set<u256> tags;
+	for (AssemblyItem const& item: optimisedItems)
+		if (item.type() == Tag)
+			tags.insert(item.data());
+	if (any_of(optimisedItems.begin(), optimisedItems.end(), [&](AssemblyItem const& _item) {
+		return _item.type() == PushTag && !tags.count(_item.data());
+	}))
+		return false;
+
+	if (optimisedItems.size() >= _items.size())
+		return false;
+	_items = move(optimisedItems);
+	return true;
+}
+
+/// @returns the tags that can only be reached by a single JUMPI, i.e. tags that are not referenced
+/// from outside and pushed only once, directly before a JUMPI.
+set<u256> singleJumpTargets(AssemblyItems const& _items, set<size_t> const& _tagsReferencedFromOutside)
+{
+	map<u256, size_t> pushes;
+	set<u256> jumpTargets;
+	for (size_t i = 0; i < _items.size(); ++i)
+		if (_items[i].type() == PushTag && _items[i].splitForeignPushTag().first == size_t(-1))
+		{
+			pushes[_items[i].data()]++;
+			if (i + 1 < _items.size() && _items[i + 1] == AssemblyItem(Instruction::JUMPI))
+				jumpTargets.insert(_items[i].data());
+		}
+	set<u256> targets;
+	for (u256 const& tag: jumpTargets)
+		if (pushes[tag] == 1 && !_tagsReferencedFromOutside.count(size_t(tag)))
+			targets.insert(tag);
+	return targets;
+}
+
+}
+
 void Assembly::append(Assembly const& _a)
 {
 	auto newDeposit = m_deposit + _a.deposit();
@@ -69,6 +218,14 @@ void Assembly::append(Assembly const& _a)
 		m_libraries.insert(lib);
 }
 
+AssemblyPointer Assembly::deepCopy() const
+{
+	AssemblyPointer copy = make_shared<Assembly>(*this);
+	for (auto& sub: copy->m_subs)
+		sub = sub->deepCopy();
+	return copy;
+}
+
 void Assembly::append(Assembly const& _a, int _deposit)
 {
 	assertThrow(_deposit <= _a.m_deposit, InvalidDeposit, "");
@@ -362,7 +519,14 @@ AssemblyItem Assembly::newPushLibraryAddress(string const& _identifier)
 	return AssemblyItem(PushLibraryAddress, h);
 }
 
-Assembly& Assembly::optimise(bool _enable, EVMVersion _evmVersion, bool _isCreation, size_t _runs)
+Assembly& Assembly::optimise(
+	bool _enable,
+	EVMVersion _evmVersion,
+	bool _isCreation,
+	size_t _runs,
+	unsigned _parallelism,
+	bool _controlFlow
+)
 {
 	OptimiserSettings settings;
 	settings.isCreation = _isCreation;
@@ -373,9 +537,12 @@ Assembly& Assembly::optimise(bool _enable, EVMVersion _evmVersion, bool _isCreat
 		settings.runDeduplicate = true;
 		settings.runCSE = true;
 		settings.runConstantOptimiser = true;
+		settings.runControlFlowOptimiser = _controlFlow;
+		settings.runExtendedBasicBlockCSE = _controlFlow;
 	}
 	settings.evmVersion = _evmVersion;
 	settings.expectedExecutionsPerDeployment = _runs;
+	settings.parallelism = _parallelism;
 	optimise(settings);
 	return *this;
 }
@@ -387,26 +554,77 @@ Assembly& Assembly::optimise(OptimiserSettings const& _settings)
 	return *this;
 }
 
+vector<map<u256, u256>> Assembly::optimiseSubAssemblies(OptimiserSettings const& _settings)
+{
+	OptimiserSettings settings = _settings;
+	// Disable creation mode for sub-assemblies.
+	settings.isCreation = false;
+
+	// The tags referenced from this assembly only change through the replacements of the
+	// respective sub-assembly, so they can be determined for all sub-assemblies upfront.
+	vector<set<size_t>> referencedTags;
+	for (size_t subId = 0; subId < m_subs.size(); ++subId)
+		referencedTags.push_back(JumpdestRemover::referencedTags(m_items, subId));
+
+	vector<map<u256, u256>> tagReplacements(m_subs.size());
+	if (settings.parallelism <= 1 || m_subs.size() <= 1)
+	{
+		for (size_t subId = 0; subId < m_subs.size(); ++subId)
+			tagReplacements[subId] = m_subs[subId]->optimiseInternal(settings, referencedTags[subId]);
+		return tagReplacements;
+	}
+
+	// Sub-assemblies are distinct objects (see deepCopy) and can be optimised independently.
+	// Their own sub-assemblies are optimised serially to bound the number of threads.
+	settings.parallelism = 1;
+	atomic<size_t> nextSubId{0};
+	vector<exception_ptr> failures(m_subs.size());
+	TimingReport* timingReport = TimingReport::current();
+	auto worker = [&]()
+	{
+		TimingReport::Activation timingActivation(timingReport);
+		for (size_t subId = nextSubId++; subId < m_subs.size(); subId = nextSubId++)
+			try
+			{
+				tagReplacements[subId] = m_subs[subId]->optimiseInternal(settings, referencedTags[subId]);
+			}
+			catch (...)
+			{
+				failures[subId] = current_exception();
+			}
+	};
+	vector<thread> threads;
+	for (size_t i = 1; i < min<size_t>(_settings.parallelism, m_subs.size()); ++i)
+		threads.emplace_back(worker);
+	worker();
+	for (auto& workerThread: threads)
+		workerThread.join();
+
+	// Report the failure of the first sub-assembly to be independent of the scheduling.
+	for (auto const& failure: failures)
+		if (failure)
+			rethrow_exception(failure);
+	return tagReplacements;
+}
+
 map<u256, u256> Assembly::optimiseInternal(
 	OptimiserSettings const& _settings,
 	std::set<size_t> const& _tagsReferencedFromOutside
 )
 {
 	// Run optimisation for sub-assemblies.
+	vector<map<u256, u256>> subTagReplacements = optimiseSubAssemblies(_settings);
+	// Apply the replacements (can be empty) in the order of the sub-assemblies, so that the
+	// result does not depend on the order in which the sub-assemblies were optimised.
 	for (size_t subId = 0; subId < m_subs.size(); ++subId)
-	{
-		OptimiserSettings settings = _settings;
-		// Disable creation mode for sub-assemblies.
-		settings.isCreation = false;
-		map<u256, u256> subTagReplacements = m_subs[subId]->optimiseInternal(
-			settings,
-			JumpdestRemover::referencedTags(m_items, subId)
-		);
-		// Apply the replacements (can be empty).
-		BlockDeduplicator::applyTagReplacement(m_items, subTagReplacements, subId);
-	}
+		BlockDeduplicator::applyTagReplacement(m_items, subTagReplacements[subId], subId);
 
 	map<u256, u256> tagReplacements;
+	// Blocks the common subexpression eliminator could not improve, grouped by their hash.
+	// The eliminator only depends on the items of a block, so these blocks are skipped in later
+	// rounds as long as they are unchanged and only modified blocks are analysed again.
+	unordered_multimap<size_t, AssemblyItems> stableBlocks;
+	bool stableBlocksUseMSize = false;
 	// Iterate until no new optimisation possibilities are found.
 	for (unsigned count = 1; count > 0;)
 	{
@@ -414,16 +632,22 @@ map<u256, u256> Assembly::optimiseInternal(
 
 		if (_settings.runJumpdestRemover)
 		{
+			TimingScope timing("optimiser.jumpdestRemover");
 			JumpdestRemover jumpdestOpt(m_items);
 			if (jumpdestOpt.optimise(_tagsReferencedFromOutside))
+			{
+				timing.count("changes");
 				count++;
+			}
 		}
 
 		if (_settings.runPeephole)
 		{
+			TimingScope timing("optimiser.peephole");
 			PeepholeOptimiser peepOpt(m_items);
 			while (peepOpt.optimise())
 			{
+				timing.count("changes");
 				count++;
 				assertThrow(count < 64000, OptimizerException, "Peephole optimizer seems to be stuck.");
 			}
@@ -432,30 +656,100 @@ map<u256, u256> Assembly::optimiseInternal(
 		// This only modifies PushTags, we have to run again to actually remove code.
 		if (_settings.runDeduplicate)
 		{
+			TimingScope timing("optimiser.deduplicate");
 			BlockDeduplicator dedup(m_items);
 			if (dedup.deduplicate())
 			{
+				timing.count("changes");
+				timing.count("bytesSaved", dedup.bytesSaved());
 				tagReplacements.insert(dedup.replacedTags().begin(), dedup.replacedTags().end());
 				count++;
 			}
 		}
 
+		if (_settings.runControlFlowOptimiser && hasClosedTagSet(m_items, _tagsReferencedFromOutside))
+		{
+			TimingScope timing("optimiser.controlFlow");
+			bool usesMSize = (find(m_items.begin(), m_items.end(), AssemblyItem(Instruction::MSIZE)) != m_items.end());
+			bool changed = false;
+			try
+			{
+				changed = optimiseControlFlow(m_items, usesMSize);
+			}
+			catch (OptimizerException const&)
+			{
+				// This stage is optional, keep the code as it is.
+			}
+			if (changed)
+			{
+				timing.count("changes");
+				count++;
+			}
+		}
+
 		if (_settings.runCSE)
 		{
-			// Control flow graph optimization has been here before but is disabled because it
+			TimingScope timing("optimiser.cse");
+			// Control flow graph optimization is only done in the opt-in stage above because it
 			// assumes we only jump to tags that are pushed. This is not the case anymore with
 			// function types that can be stored in storage.
 			AssemblyItems optimisedItems;
 
 			bool usesMSize = (find(m_items.begin(), m_items.end(), AssemblyItem(Instruction::MSIZE)) != m_items.end());
+			if (usesMSize != stableBlocksUseMSize)
+			{
+				stableBlocks.clear();
+				stableBlocksUseMSize = usesMSize;
+			}
+
+			// With extended basic blocks, the knowledge about the state after a JUMPI is carried
+			// into its fall-through and into the tag it jumps to if that tag cannot be reached in
+			// any other way. Carrying it across other breaking items does not pay off.
+			bool const extendedBlocks = _settings.runExtendedBasicBlockCSE;
+			set<u256> const jumpTargets =
+				extendedBlocks ? singleJumpTargets(m_items, _tagsReferencedFromOutside) : set<u256>();
+			map<u256, KnownStatePointer> jumpTargetStates;
+			KnownStatePointer carriedState;
 
 			auto iter = m_items.begin();
 			while (iter != m_items.end())
 			{
-				KnownState emptyState;
-				CommonSubexpressionEliminator eliminator(emptyState);
 				auto orig = iter;
-				iter = eliminator.feedItems(iter, m_items.end(), usesMSize);
+				bool const previousTerminates =
+					orig != m_items.begin() &&
+					SemanticInformation::altersControlFlow(*prev(orig)) &&
+					*prev(orig) != AssemblyItem(Instruction::JUMPI);
+				iter = find_if(orig, m_items.end(), [&](AssemblyItem const& _item) {
+					return SemanticInformation::breaksCSEAnalysisBlock(_item, usesMSize);
+				});
+				AssemblyItem const* breakingItem = nullptr;
+				if (iter != m_items.end())
+					breakingItem = &*iter++;
+				KnownStatePointer initialState = move(carriedState);
+				if (breakingItem && breakingItem->type() == Tag)
+				{
+					if (iter - orig == 1 && previousTerminates && jumpTargetStates.count(breakingItem->data()))
+						carriedState = jumpTargetStates.at(breakingItem->data());
+					breakingItem = nullptr;
+				}
+				bool const stateNeeded = extendedBlocks && breakingItem && *breakingItem == AssemblyItem(Instruction::JUMPI);
+
+				size_t hash = blockHash(orig, iter);
+				if (!initialState && !stateNeeded)
+				{
+					auto stable = stableBlocks.equal_range(hash);
+					if (any_of(stable.first, stable.second, [&](pair<size_t const, AssemblyItems> const& _block) {
+						return _block.second.size() == size_t(iter - orig) && equal(orig, iter, _block.second.begin());
+					}))
+					{
+						timing.count("skippedBlocks");
+						copy(orig, iter, back_inserter(optimisedItems));
+						continue;
+					}
+				}
+
+				CommonSubexpressionEliminator eliminator(initialState ? *initialState : KnownState());
+				assertThrow(eliminator.feedItems(orig, m_items.end(), usesMSize) == iter, OptimizerException, "");
 				bool shouldReplace = false;
 				AssemblyItems optimisedChunk;
 				try
@@ -474,13 +768,28 @@ map<u256, u256> Assembly::optimiseInternal(
 					// reorganise the expression tree, but not all leaves are available.
 				}
 
+				if (stateNeeded)
+				{
+					// The state also describes the original items, so it is valid independent
+					// of whether the chunk is replaced.
+					carriedState = make_shared<KnownState>(eliminator.state());
+					if (iter - orig >= 2 && prev(iter, 2)->type() == PushTag && jumpTargets.count(prev(iter, 2)->data()))
+						jumpTargetStates[prev(iter, 2)->data()] = carriedState;
+				}
+
 				if (shouldReplace)
 				{
+					timing.count("changes");
 					count++;
 					optimisedItems += optimisedChunk;
 				}
 				else
+				{
 					copy(orig, iter, back_inserter(optimisedItems));
+					// Values that are only known after assembly make the result depend on more than the items.
+					if (!initialState && none_of(orig, iter, [](AssemblyItem const& _item) { return !!_item.pushedValue(); }))
+						stableBlocks.emplace(hash, AssemblyItems(orig, iter));
+				}
 			}
 			if (optimisedItems.size() < m_items.size())
 			{
@@ -491,13 +800,16 @@ map<u256, u256> Assembly::optimiseInternal(
 	}
 
 	if (_settings.runConstantOptimiser)
-		ConstantOptimisationMethod::optimiseConstants(
+	{
+		TimingScope timing("optimiser.constantOptimiser");
+		timing.count("changes", ConstantOptimisationMethod::optimiseConstants(
 			_settings.isCreation,
 			_settings.isCreation ? 1 : _settings.expectedExecutionsPerDeployment,
 			_settings.evmVersion,
 			*this,
 			m_items
-		);
+		));
+	}
 
 	return tagReplacements;
 }
@@ -56,6 +56,9 @@ public:
 	AssemblyItem newSub(AssemblyPointer const& _sub) { m_subs.push_back(_sub); return AssemblyItem(PushSub, m_subs.size() - 1); }
 	Assembly const& sub(size_t _sub) const { return *m_subs.at(_sub); }
 	Assembly& sub(size_t _sub) { return *m_subs.at(_sub); }
+	/// @returns a copy of this assembly that does not share any sub-assemblies with the original,
+	/// so that it can be optimised without modifying the original.
+	AssemblyPointer deepCopy() const;
 	AssemblyItem newPushSubSize(u256 const& _subId) { return AssemblyItem(PushSubSize, _subId); }
 	AssemblyItem newPushLibraryAddress(std::string const& _identifier);
 
@@ -106,10 +109,20 @@ public:
 		bool runDeduplicate = false;
 		bool runCSE = false;
 		bool runConstantOptimiser = false;
+		/// Remove unreachable blocks, reorder blocks using the control flow graph and start blocks
+		/// with only one predecessor with its knowledge. Only done for assemblies whose tags are
+		/// not referenced from other assemblies.
+		bool runControlFlowOptimiser = false;
+		/// Let the common subexpression eliminator carry its knowledge from a JUMPI into the
+		/// next block and into the block it jumps to if that block cannot be reached otherwise.
+		bool runExtendedBasicBlockCSE = false;
 		solidity::EVMVersion evmVersion;
 		/// This specifies an estimate on how often each opcode in this assembly will be executed,
 		/// i.e. use a small value to optimise for size and a large value to optimise for runtime gas usage.
 		size_t expectedExecutionsPerDeployment = 200;
+		/// Maximum number of threads used to optimise independent sub-assemblies concurrently.
+		/// The result does not depend on this value.
+		unsigned parallelism = 1;
 	};
 
 	/// Execute optimisation passes as defined by @a _settings and return the optimised assembly.
@@ -120,7 +133,16 @@ public:
 	/// @a _runs specifes an estimate on how often each opcode in this assembly will be executed,
 	/// i.e. use a small value to optimise for size and a large value to optimise for runtime.
 	/// If @a _enable is not set, will perform some simple peephole optimizations.
-	Assembly& optimise(bool _enable, EVMVersion _evmVersion, bool _isCreation = true, size_t _runs = 200);
+	/// @a _parallelism is the maximum number of threads used to optimise sub-assemblies.
+	/// @a _controlFlow enables the optimisations across basic blocks (only if @a _enable is set).
+	Assembly& optimise(
+		bool _enable,
+		EVMVersion _evmVersion,
+		bool _isCreation = true,
+		size_t _runs = 200,
+		unsigned _parallelism = 1,
+		bool _controlFlow = false
+	);
 
 	/// Create a text representation of the assembly.
 	std::string assemblyString(
@@ -154,6 +176,9 @@ protected:
 	/// returns the replaced tags. Also takes an argument containing the tags of this assembly
 	/// that are referenced in a super-assembly.
 	std::map<u256, u256> optimiseInternal(OptimiserSettings const& _settings, std::set<size_t> const& _tagsReferencedFromOutside);
+	/// Optimises all sub-assemblies, using up to @a _settings.parallelism threads, and returns
+	/// the tag replacements of each of them.
+	std::vector<std::map<u256, u256>> optimiseSubAssemblies(OptimiserSettings const& _settings);
 
 	unsigned bytesRequired(unsigned subTagSize) const;
 
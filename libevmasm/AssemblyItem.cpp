@@ -20,6 +20,8 @@
 #include <libdevcore/CommonData.h>
 #include <libdevcore/FixedHash.h>
 
+#include <boost/functional/hash.hpp>
+
 #include <fstream>
 
 using namespace std;
@@ -57,6 +59,17 @@ void AssemblyItem::setPushTagSubIdAndTag(size_t _subId, size_t _tag)
 	setData(data);
 }
 
+size_t dev::eth::hashValue(AssemblyItem const& _item)
+{
+	size_t hash = 0;
+	boost::hash_combine(hash, size_t(_item.type()));
+	if (_item.type() == Operation)
+		boost::hash_combine(hash, size_t(_item.instruction()));
+	else
+		boost::hash_combine(hash, size_t(_item.data() & u256(uint64_t(-1))));
+	return hash;
+}
+
 unsigned AssemblyItem::bytesRequired(unsigned _addressLength) const
 {
 	switch (m_type)
@@ -71,7 +71,7 @@ public:
 		if (m_type == Operation)
 			m_instruction = Instruction(byte(_data));
 		else
-			m_data = std::make_shared<u256>(_data);
+			setData(_data);
 	}
 
 	AssemblyItem tag() const { assertThrow(m_type == PushTag || m_type == Tag, Exception, ""); return AssemblyItem(Tag, data()); }
@@ -86,8 +86,25 @@ public:
 	void setPushTagSubIdAndTag(size_t _subId, size_t _tag);
 
 	AssemblyItemType type() const { return m_type; }
-	u256 const& data() const { assertThrow(m_type != Operation, Exception, ""); return *m_data; }
-	void setData(u256 const& _data) { assertThrow(m_type != Operation, Exception, ""); m_data = std::make_shared<u256>(_data); }
+	u256 data() const
+	{
+		assertThrow(m_type != Operation, Exception, "");
+		return m_largeData ? *m_largeData : u256(m_smallData);
+	}
+	void setData(u256 const& _data)
+	{
+		assertThrow(m_type != Operation, Exception, "");
+		if (_data >> 64 == 0)
+		{
+			m_smallData = uint64_t(_data);
+			m_largeData.reset();
+		}
+		else
+		{
+			m_smallData = 0;
+			m_largeData = std::make_shared<u256 const>(_data);
+		}
+	}
 
 	/// @returns the instruction of this item (only valid if type() == Operation)
 	Instruction instruction() const { assertThrow(m_type == Operation, Exception, ""); return m_instruction; }
@@ -99,8 +116,10 @@ public:
 			return false;
 		if (type() == Operation)
 			return instruction() == _other.instruction();
+		else if (!m_largeData || !_other.m_largeData)
+			return !m_largeData && !_other.m_largeData && m_smallData == _other.m_smallData;
 		else
-			return data() == _other.data();
+			return m_largeData == _other.m_largeData || *m_largeData == *_other.m_largeData;
 	}
 	bool operator!=(AssemblyItem const& _other) const { return !operator==(_other); }
 	/// Less-than operator compatible with operator==.
@@ -110,8 +129,11 @@ public:
 			return type() < _other.type();
 		else if (type() == Operation)
 			return instruction() < _other.instruction();
+		// Large values are at least 2**64 and thus larger than all values that are stored inline.
+		else if (!m_largeData || !_other.m_largeData)
+			return m_largeData ? false : (_other.m_largeData || m_smallData < _other.m_smallData);
 		else
-			return data() < _other.data();
+			return *m_largeData < *_other.m_largeData;
 	}
 
 	/// @returns an upper bound for the number of bytes required by this item, assuming that
@@ -131,7 +153,7 @@ public:
 	JumpType getJumpType() const { return m_jumpType; }
 	std::string getJumpTypeAsString() const;
 
-	void setPushedValue(u256 const& _value) const { m_pushedValue = std::make_shared<u256>(_value); }
+	void setPushedValue(u256 const& _value) const { m_pushedValue = std::make_shared<u256 const>(_value); }
 	u256 const* pushedValue() const { return m_pushedValue.get(); }
 
 	std::string toAssemblyText() const;
@@ -139,16 +161,23 @@ public:
 private:
 	AssemblyItemType m_type;
 	Instruction m_instruction; ///< Only valid if m_type == Operation
-	std::shared_ptr<u256> m_data; ///< Only valid if m_type != Operation
-	SourceLocation m_location;
 	JumpType m_jumpType = JumpType::Ordinary;
+	/// Data of the item if m_type != Operation. Values below 2**64 (tags, sub ids and most
+	/// pushed constants) are stored inline, larger ones in an immutable value that is shared
+	/// between copies of the item.
+	uint64_t m_smallData = 0;
+	std::shared_ptr<u256 const> m_largeData;
+	SourceLocation m_location;
 	/// Pushed value for operations with data to be determined during assembly stage,
 	/// e.g. PushSubSize, PushTag, PushSub, etc.
-	mutable std::shared_ptr<u256> m_pushedValue;
+	mutable std::shared_ptr<u256 const> m_pushedValue;
 };
 
 using AssemblyItems = std::vector<AssemblyItem>;
 
+/// @returns a hash of the type and data of @a _item that is compatible with AssemblyItem::operator==.
+size_t hashValue(AssemblyItem const& _item);
+
 inline size_t bytesRequired(AssemblyItems const& _items, size_t _addressLength)
 {
 	size_t size = 0;
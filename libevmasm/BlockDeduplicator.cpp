@@ -26,8 +26,10 @@
 #include <libevmasm/AssemblyItem.h>
 #include <libevmasm/SemanticInformation.h>
 
+#include <boost/functional/hash.hpp>
+
 #include <functional>
-#include <set>
+#include <unordered_map>
 
 using namespace std;
 using namespace dev;
@@ -48,45 +50,54 @@ bool BlockDeduplicator::deduplicate()
 	)
 		return false;
 
-	function<bool(size_t, size_t)> comparator = [&](size_t _i, size_t _j)
+	// Iterates over the suffix that starts at index @a _i, replacing PushTag operations
+	// of the block's own tag by the virtual tag. This unifies recursive loops.
+	auto suffixBegin = [&](size_t _i, AssemblyItem& _pushOwnTag)
 	{
-		if (_i == _j)
-			return false;
-
-		// To compare recursive loops, we have to already unify PushTag opcodes of the
-		// block's own tag.
-		AssemblyItem pushFirstTag(pushSelf);
-		AssemblyItem pushSecondTag(pushSelf);
-
 		if (_i < m_items.size() && m_items.at(_i).type() == Tag)
-			pushFirstTag = m_items.at(_i).pushTag();
-		if (_j < m_items.size() && m_items.at(_j).type() == Tag)
-			pushSecondTag = m_items.at(_j).pushTag();
-
-		BlockIterator first(m_items.begin() + _i, m_items.end(), &pushFirstTag, &pushSelf);
-		BlockIterator second(m_items.begin() + _j, m_items.end(), &pushSecondTag, &pushSelf);
-		BlockIterator end(m_items.end(), m_items.end());
+			_pushOwnTag = m_items.at(_i).pushTag();
+		BlockIterator begin(m_items.begin() + _i, m_items.end(), &_pushOwnTag, &pushSelf);
+		if (begin != BlockIterator(m_items.end(), m_items.end()) && (*begin).type() == Tag)
+			++begin;
+		return begin;
+	};
+	BlockIterator end(m_items.end(), m_items.end());
 
-		if (first != end && (*first).type() == Tag)
-			++first;
-		if (second != end && (*second).type() == Tag)
-			++second;
+	auto suffixHash = [&](size_t _i)
+	{
+		AssemblyItem pushOwnTag(pushSelf);
+		size_t hash = 0;
+		for (BlockIterator it = suffixBegin(_i, pushOwnTag); it != end; ++it)
+			boost::hash_combine(hash, hashValue(*it));
+		return hash;
+	};
 
-		return std::lexicographical_compare(first, end, second, end);
+	auto suffixesEqual = [&](size_t _i, size_t _j)
+	{
+		AssemblyItem pushFirstTag(pushSelf);
+		AssemblyItem pushSecondTag(pushSelf);
+		BlockIterator first = suffixBegin(_i, pushFirstTag);
+		BlockIterator second = suffixBegin(_j, pushSecondTag);
+		for (; first != end && second != end; ++first, ++second)
+			if (!(*first == *second))
+				return false;
+		return first == end && second == end;
 	};
 
 	size_t iterations = 0;
 	for (; ; ++iterations)
 	{
-		//@todo this should probably be optimized.
-		set<size_t, function<bool(size_t, size_t)>> blocksSeen(comparator);
+		// Maps the hashes of the suffixes starting at tags to the positions of the first
+		// tag of each of the distinct suffixes with that hash.
+		unordered_map<size_t, vector<size_t>> blocksSeen;
 		for (size_t i = 0; i < m_items.size(); ++i)
 		{
 			if (m_items.at(i).type() != Tag)
 				continue;
-			auto it = blocksSeen.find(i);
-			if (it == blocksSeen.end())
-				blocksSeen.insert(i);
+			vector<size_t>& candidates = blocksSeen[suffixHash(i)];
+			auto it = find_if(candidates.begin(), candidates.end(), [&](size_t _j) { return suffixesEqual(i, _j); });
+			if (it == candidates.end())
+				candidates.push_back(i);
 			else
 				m_replacedTags[m_items.at(i).data()] = m_items.at(*it).data();
 		}
@@ -94,6 +105,26 @@ bool BlockDeduplicator::deduplicate()
 		if (!applyTagReplacement(m_items, m_replacedTags))
 			break;
 	}
+
+	auto endsBlock = [](AssemblyItem const& _item)
+	{
+		return SemanticInformation::altersControlFlow(_item) && _item != AssemblyItem(Instruction::JUMPI);
+	};
+	m_bytesSaved = 0;
+	for (size_t i = 1; i < m_items.size(); ++i)
+		if (
+			m_items.at(i).type() == Tag &&
+			m_replacedTags.count(m_items.at(i).data()) &&
+			endsBlock(m_items.at(i - 1))
+		)
+			// The block can neither be jumped to nor be reached by falling through,
+			// so it will be removed as unreachable code.
+			for (size_t j = i; j < m_items.size() && (j == i || m_items.at(j).type() != Tag); ++j)
+			{
+				m_bytesSaved += m_items.at(j).bytesRequired(3); // assume 3 byte addresses
+				if (endsBlock(m_items.at(j)))
+					break;
+			}
 	return iterations > 0;
 }
 
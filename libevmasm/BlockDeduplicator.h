@@ -50,6 +50,9 @@ public:
 	bool deduplicate();
 	/// @returns the tags that were replaced.
 	std::map<u256, u256> const& replacedTags() const { return m_replacedTags; }
+	/// @returns an estimate of the number of bytes of code in the blocks that became
+	/// unreachable by the last call to deduplicate().
+	size_t bytesSaved() const { return m_bytesSaved; }
 
 	/// Replaces all PushTag operations insied @a _items that match a key in
 	/// @a _replacements by the respective value. If @a _subID is not -1, only
@@ -86,6 +89,7 @@ private:
 	};
 
 	std::map<u256, u256> m_replacedTags;
+	size_t m_bytesSaved = 0;
 	AssemblyItems& m_items;
 };
 
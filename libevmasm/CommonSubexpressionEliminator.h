@@ -72,6 +72,10 @@ public:
 	/// @returns the resulting items after optimization.
 	AssemblyItems getOptimizedItems();
 
+	/// @returns the knowledge about the state after the items fed so far. After a call to
+	/// getOptimizedItems(), this includes the effect of the item that broke the block.
+	KnownState const& state() const { return m_state; }
+
 private:
 	/// Feeds the item into the system for analysis.
 	void feedItem(AssemblyItem const& _item, bool _copyItem = false);
@@ -22,10 +22,45 @@
 #include <libevmasm/ConstantOptimiser.h>
 #include <libevmasm/Assembly.h>
 #include <libevmasm/GasMeter.h>
+
+#include <libdevcore/LRUCache.h>
+#include <libdevcore/TimingReport.h>
+
+#include <map>
+#include <tuple>
+
 using namespace std;
 using namespace dev;
 using namespace dev::eth;
 
+namespace
+{
+
+/// Which representation the optimiser chose for a constant and, if it is computed,
+/// the routine that computes it.
+struct CachedDecision
+{
+	enum class Method { Literal, CodeCopy, Compute };
+	Method method;
+	AssemblyItems routine;
+};
+
+/// The decision depends on the value, on whether it is used in creation code, on the number
+/// of runs, on how often the value occurs in the assembly and on the EVM version.
+using DecisionKey = tuple<u256, bool, size_t, size_t, solidity::EVMVersion>;
+
+/// Process-wide cache of the decisions of the constant optimiser. Contracts compiled with
+/// the same settings tend to use the same constants, so the search for a cheap computation
+/// does not have to be repeated for each of them. Only the decision is cached for the
+/// code copy method because its data is specific to an assembly.
+LRUCache<DecisionKey, CachedDecision>& decisionCache()
+{
+	static LRUCache<DecisionKey, CachedDecision> cache(0x10000);
+	return cache;
+}
+
+}
+
 unsigned ConstantOptimisationMethod::optimiseConstants(
 	bool _isCreation,
 	size_t _runs,
@@ -50,21 +85,40 @@ unsigned ConstantOptimisationMethod::optimiseConstants(
 		params.isCreation = _isCreation;
 		params.runs = _runs;
 		params.evmVersion = _evmVersion;
-		LiteralMethod lit(params, item.data());
-		bigint literalGas = lit.gasNeeded();
-		CodeCopyMethod copy(params, item.data());
-		bigint copyGas = copy.gasNeeded();
-		ComputeMethod compute(params, item.data());
-		bigint computeGas = compute.gasNeeded();
+		DecisionKey key(item.data(), _isCreation, _runs, it.second, _evmVersion);
+		CachedDecision decision;
+		if (auto cached = decisionCache().lookup(key))
+		{
+			decision = std::move(*cached);
+			TimingScope::countInCurrent("cacheHits");
+		}
+		else
+		{
+			LiteralMethod lit(params, item.data());
+			bigint literalGas = lit.gasNeeded();
+			CodeCopyMethod copy(params, item.data());
+			bigint copyGas = copy.gasNeeded();
+			ComputeMethod compute(params, item.data());
+			bigint computeGas = compute.gasNeeded();
+			decision.method = CachedDecision::Method::Literal;
+			if (copyGas < literalGas && copyGas < computeGas)
+				decision.method = CachedDecision::Method::CodeCopy;
+			else if (computeGas < literalGas && computeGas <= copyGas)
+			{
+				decision.method = CachedDecision::Method::Compute;
+				decision.routine = compute.execute(_assembly);
+			}
+			decisionCache().store(key, decision);
+		}
 		AssemblyItems replacement;
-		if (copyGas < literalGas && copyGas < computeGas)
+		if (decision.method == CachedDecision::Method::CodeCopy)
 		{
-			replacement = copy.execute(_assembly);
+			replacement = CodeCopyMethod(params, item.data()).execute(_assembly);
 			optimisations++;
 		}
-		else if (computeGas < literalGas && computeGas <= copyGas)
+		else if (decision.method == CachedDecision::Method::Compute)
 		{
-			replacement = compute.execute(_assembly);
+			replacement = std::move(decision.routine);
 			optimisations++;
 		}
 		if (!replacement.empty())
@@ -27,6 +27,7 @@
 #include <functional>
 #include <boost/range/adaptor/reversed.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/functional/hash.hpp>
 #include <libevmasm/Assembly.h>
 #include <libevmasm/CommonSubexpressionEliminator.h>
 #include <libevmasm/SimplificationRules.h>
@@ -50,9 +51,29 @@ bool ExpressionClasses::Expression::operator<(ExpressionClasses::Expression cons
 		return std::tie(instr, arguments, sequenceNumber) <
 			std::tie(otherInstr, _other.arguments, _other.sequenceNumber);
 	}
+	else if (*item != *_other.item)
+		return *item < *_other.item;
 	else
-		return std::tie(item->data(), arguments, sequenceNumber) <
-			std::tie(_other.item->data(), _other.arguments, _other.sequenceNumber);
+		return std::tie(arguments, sequenceNumber) <
+			std::tie(_other.arguments, _other.sequenceNumber);
+}
+
+bool ExpressionClasses::Expression::operator==(ExpressionClasses::Expression const& _other) const
+{
+	assertThrow(!!item && !!_other.item, OptimizerException, "");
+	return
+		*item == *_other.item &&
+		arguments == _other.arguments &&
+		sequenceNumber == _other.sequenceNumber;
+}
+
+size_t ExpressionClasses::ExpressionHash::operator()(ExpressionClasses::Expression const& _expression) const
+{
+	assertThrow(!!_expression.item, OptimizerException, "");
+	size_t hash = hashValue(*_expression.item);
+	boost::hash_range(hash, _expression.arguments.begin(), _expression.arguments.end());
+	boost::hash_combine(hash, _expression.sequenceNumber);
+	return hash;
 }
 
 ExpressionClasses::Id ExpressionClasses::find(
@@ -62,22 +83,24 @@ ExpressionClasses::Id ExpressionClasses::find(
 	unsigned _sequenceNumber
 )
 {
-	Expression exp;
-	exp.id = Id(-1);
-	exp.item = &_item;
-	exp.arguments = _arguments;
-	exp.sequenceNumber = _sequenceNumber;
+	// The lookup key is reused to avoid allocating its arguments for every lookup.
+	m_lookupKey.id = Id(-1);
+	m_lookupKey.item = &_item;
+	m_lookupKey.arguments.assign(_arguments.begin(), _arguments.end());
+	m_lookupKey.sequenceNumber = _sequenceNumber;
 
 	if (SemanticInformation::isCommutativeOperation(_item))
-		sort(exp.arguments.begin(), exp.arguments.end());
+		sort(m_lookupKey.arguments.begin(), m_lookupKey.arguments.end());
 
 	if (SemanticInformation::isDeterministic(_item))
 	{
-		auto it = m_expressions.find(exp);
+		auto it = m_expressions.find(m_lookupKey);
 		if (it != m_expressions.end())
 			return it->id;
 	}
 
+	Expression exp = m_lookupKey;
+
 	if (_copyItem)
 		exp.item = storeItem(_item);
 
@@ -133,7 +156,7 @@ bool ExpressionClasses::knownToBeDifferent(ExpressionClasses::Id _a, ExpressionC
 bool ExpressionClasses::knownToBeDifferentBy32(ExpressionClasses::Id _a, ExpressionClasses::Id _b)
 {
 	// Try to simplify "_a - _b" and return true iff the value is at least 32 away from zero.
-	u256 const* v = knownConstant(find(Instruction::SUB, {_a, _b}));
+	boost::optional<u256> v = knownConstant(find(Instruction::SUB, {_a, _b}));
 	// forbidden interval is ["-31", 31]
 	return v && *v + 31 > u256(62);
 }
@@ -148,14 +171,14 @@ bool ExpressionClasses::knownNonZero(Id _c)
 	return Pattern(u256(0)).matches(representative(find(Instruction::ISZERO, {_c})), *this);
 }
 
-u256 const* ExpressionClasses::knownConstant(Id _c)
+boost::optional<u256> ExpressionClasses::knownConstant(Id _c)
 {
-	map<unsigned, Expression const*> matchGroups;
+	MatchGroups matchGroups;
 	Pattern constant(Push);
 	constant.setMatchGroup(1, matchGroups);
 	if (!constant.matches(representative(_c), *this))
-		return nullptr;
-	return &constant.d();
+		return boost::none;
+	return constant.d();
 }
 
 AssemblyItem const* ExpressionClasses::storeItem(AssemblyItem const& _item)
@@ -183,7 +206,7 @@ string ExpressionClasses::fullDAGToString(ExpressionClasses::Id _id) const
 
 ExpressionClasses::Id ExpressionClasses::tryToSimplify(Expression const& _expr)
 {
-	static Rules rules;
+	static thread_local Rules rules;
 	assertThrow(rules.isInitialized(), OptimizerException, "Rule list not properly initialized.");
 
 	if (
@@ -26,10 +26,13 @@
 #include <libdevcore/Common.h>
 #include <libevmasm/AssemblyItem.h>
 
+#include <boost/optional.hpp>
+
 #include <vector>
 #include <map>
 #include <memory>
 #include <set>
+#include <unordered_set>
 
 namespace dev
 {
@@ -58,6 +61,13 @@ public:
 		unsigned sequenceNumber = 0;
 		/// Behaves as if this was a tuple of (item->type(), item->data(), arguments, sequenceNumber).
 		bool operator<(Expression const& _other) const;
+		/// Equivalence compatible with operator<, ignores the id.
+		bool operator==(Expression const& _other) const;
+	};
+	/// Hash compatible with Expression::operator==.
+	struct ExpressionHash
+	{
+		size_t operator()(Expression const& _expression) const;
 	};
 
 	/// Retrieves the id of the expression equivalence class resulting from the given item applied to the
@@ -95,9 +105,8 @@ public:
 	/// @returns true if the value of the given class is known to be nonzero.
 	/// @note that this is not the negation of knownZero
 	bool knownNonZero(Id _c);
-	/// @returns a pointer to the value if the given class is known to be a constant,
-	/// and a nullptr otherwise.
-	u256 const* knownConstant(Id _c);
+	/// @returns the value if the given class is known to be a constant and an empty optional otherwise.
+	boost::optional<u256> knownConstant(Id _c);
 
 	/// Stores a copy of the given AssemblyItem and returns a pointer to the copy that is valid for
 	/// the lifetime of the ExpressionClasses object.
@@ -117,8 +126,10 @@ private:
 
 	/// Expression equivalence class representatives - we only store one item of an equivalence.
 	std::vector<Expression> m_representatives;
-	/// All expression ever encountered.
-	std::set<Expression> m_expressions;
+	/// All expression ever encountered, hash-consed on their item, arguments and sequence number.
+	std::unordered_set<Expression, ExpressionHash> m_expressions;
+	/// Key used by find for lookups in m_expressions.
+	Expression m_lookupKey;
 	std::vector<std::shared_ptr<AssemblyItem>> m_spareAssemblyItems;
 };
 
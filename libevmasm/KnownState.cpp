@@ -175,6 +175,23 @@ KnownState::StoreOperation KnownState::feedItem(AssemblyItem const& _item, bool
 	return op;
 }
 
+void KnownState::replaceStackTop(int _removed, int _added, SourceLocation const& _location)
+{
+	m_stackElements.erase(m_stackElements.upper_bound(m_stackHeight - _removed), m_stackElements.end());
+	m_stackHeight -= _removed;
+	for (int i = 0; i < _added; ++i)
+		setStackElement(++m_stackHeight, m_expressionClasses->newClass(_location));
+}
+
+void KnownState::resetMemoryAt(u256 const& _slot, SourceLocation const& _location)
+{
+	storeInMemory(
+		m_expressionClasses->find(AssemblyItem(_slot, _location)),
+		m_expressionClasses->newClass(_location),
+		_location
+	);
+}
+
 /// Helper function for KnownState::reduceToCommonKnowledge, removes everything from
 /// _this which is not in or not equal to the value in _other.
 template <class _Mapping> void intersect(_Mapping& _this, _Mapping const& _other)
@@ -359,7 +376,7 @@ KnownState::Id KnownState::applyKeccak256(
 {
 	AssemblyItem keccak256Item(Instruction::KECCAK256, _location);
 	// Special logic if length is a short constant, otherwise we cannot tell.
-	u256 const* l = m_expressionClasses->knownConstant(_length);
+	boost::optional<u256> l = m_expressionClasses->knownConstant(_length);
 	// unknown or too large length
 	if (!l || *l > 128)
 		return m_expressionClasses->find(keccak256Item, {_start, _length}, true, m_sequenceNumber);
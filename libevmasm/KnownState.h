@@ -104,6 +104,11 @@ public:
 	void resetStack() { m_stackElements.clear(); m_stackHeight = 0; }
 	/// Resets any knowledge.
 	void reset() { resetStorage(); resetMemory(); resetStack(); }
+	/// Replaces the topmost @a _removed stack elements by @a _added elements about which nothing
+	/// is known.
+	void replaceStackTop(int _removed, int _added, SourceLocation const& _location = SourceLocation());
+	/// Resets any knowledge about the memory at @a _slot and the memory that might overlap it.
+	void resetMemoryAt(u256 const& _slot, SourceLocation const& _location = SourceLocation());
 
 	unsigned sequenceNumber() const { return m_sequenceNumber; }
 
@@ -27,12 +27,63 @@ using namespace std;
 using namespace dev;
 using namespace dev::eth;
 
-PathGasMeter::PathGasMeter(AssemblyItems const& _items, solidity::EVMVersion _evmVersion):
-	m_items(_items), m_evmVersion(_evmVersion)
+namespace
+{
+
+/// Stands for the return address while the summary of a function is computed.
+u256 const c_returnTag = u256(-0x10);
+
+}
+
+shared_ptr<map<u256, size_t> const> FunctionGasSummaries::tagPositions(AssemblyItems const& _items)
+{
+	auto positions = make_shared<map<u256, size_t>>();
+	for (size_t i = 0; i < _items.size(); ++i)
+		if (_items[i].type() == Tag)
+			(*positions)[_items[i].data()] = i;
+	return positions;
+}
+
+void FunctionGasSummaries::registerFunction(u256 const& _entryTag, unsigned _parameters)
+{
+	lock_guard<mutex> lock(m_mutex);
+	m_parameters[_entryTag] = _parameters;
+}
+
+boost::optional<unsigned> FunctionGasSummaries::parameters(u256 const& _tag) const
+{
+	lock_guard<mutex> lock(m_mutex);
+	auto it = m_parameters.find(_tag);
+	if (it == m_parameters.end())
+		return boost::none;
+	return it->second;
+}
+
+shared_ptr<FunctionGasSummary const> FunctionGasSummaries::summary(Key const& _key) const
+{
+	lock_guard<mutex> lock(m_mutex);
+	auto it = m_summaries.find(_key);
+	return it == m_summaries.end() ? nullptr : it->second;
+}
+
+void FunctionGasSummaries::storeSummary(Key const& _key, shared_ptr<FunctionGasSummary const> const& _summary)
+{
+	lock_guard<mutex> lock(m_mutex);
+	m_summaries[_key] = _summary;
+}
+
+PathGasMeter::PathGasMeter(
+	AssemblyItems const& _items,
+	solidity::EVMVersion _evmVersion,
+	FunctionGasSummaries* _functions,
+	size_t _explorationBudget
+):
+	m_tagPositions(_functions ? _functions->tagPositions() : FunctionGasSummaries::tagPositions(_items)),
+	m_items(_items),
+	m_evmVersion(_evmVersion),
+	m_functions(_functions),
+	m_explorationBudget(_explorationBudget)
 {
-	for (size_t i = 0; i < m_items.size(); ++i)
-		if (m_items[i].type() == Tag)
-			m_tagPositions[m_items[i].data()] = i;
 }
 
 GasMeter::GasConsumption PathGasMeter::estimateMax(
@@ -51,6 +102,58 @@ GasMeter::GasConsumption PathGasMeter::estimateMax(
 	return gas;
 }
 
+shared_ptr<FunctionGasSummary const> PathGasMeter::functionSummary(
+	u256 const& _entryTag,
+	u256 const& _largestMemoryAccess,
+	AssemblyItems _arguments
+)
+{
+	assertThrow(m_functions, OptimizerException, "");
+	boost::optional<unsigned> parameters = m_functions->parameters(_entryTag);
+	assertThrow(parameters && m_tagPositions->count(_entryTag), OptimizerException, "");
+	if (_arguments.empty())
+		_arguments.resize(*parameters, AssemblyItem(UndefinedItem));
+	assertThrow(_arguments.size() == *parameters, OptimizerException, "");
+	FunctionGasSummaries::Key key(_entryTag, _largestMemoryAccess, _arguments);
+	if (auto summary = m_functions->summary(key))
+	{
+		*m_visitedItems += summary->visitedItems;
+		return summary;
+	}
+
+	// Another thread might compute the same summary in the meantime, which is only wasted work.
+	PathGasMeter meter(m_items, m_evmVersion, m_functions, m_explorationBudget);
+	size_t const visitedBefore = *m_visitedItems;
+	meter.m_visitedItems = m_visitedItems;
+	meter.m_activeFunctions = m_activeFunctions;
+	meter.m_activeFunctions.insert(_entryTag);
+	meter.m_summary = make_shared<FunctionGasSummary>();
+
+	auto state = make_shared<KnownState>();
+	state->feedItem(AssemblyItem(PushTag, c_returnTag), true);
+	for (AssemblyItem const& argument: _arguments)
+		if (argument.type() == UndefinedItem)
+			state->replaceStackTop(0, 1);
+		else
+			state->feedItem(argument, true);
+	auto path = unique_ptr<GasPath>(new GasPath());
+	path->index = m_tagPositions->at(_entryTag);
+	path->state = state;
+	path->largestMemoryAccess = _largestMemoryAccess;
+	meter.queue(move(path));
+	GasMeter::GasConsumption& gas = meter.m_summary->gas;
+	while (!meter.m_queue.empty() && !gas.isInfinite)
+		gas = max(gas, meter.handleQueueItem());
+
+	if (gas.isInfinite || meter.m_summary->returnSlots < 0)
+		meter.m_summary->usable = false;
+	meter.m_summary->visitedItems = *m_visitedItems - visitedBefore;
+	// A summary cut short by the budget depends on what was visited before, so it is not shared.
+	if (*m_visitedItems <= m_explorationBudget)
+		m_functions->storeSummary(key, meter.m_summary);
+	return meter.m_summary;
+}
+
 void PathGasMeter::queue(std::unique_ptr<GasPath>&& _newPath)
 {
 	if (
@@ -84,6 +187,9 @@ GasMeter::GasConsumption PathGasMeter::handleQueueItem()
 	set<u256> jumpTags;
 	for (; index < m_items.size() && !gas.isInfinite; ++index)
 	{
+		if (++*m_visitedItems > m_explorationBudget)
+			return GasMeter::GasConsumption::infinite();
+
 		bool branchStops = false;
 		jumpTags.clear();
 		AssemblyItem const& item = m_items.at(index);
@@ -116,14 +222,67 @@ GasMeter::GasConsumption PathGasMeter::handleQueueItem()
 		else if (SemanticInformation::altersControlFlow(item))
 			branchStops = true;
 
+		if (m_summary)
+			recordEffects(item, *state);
 		gas += meter.estimateMax(item);
 
+		// A call to a registered function: Continue at the return address with the effect of
+		// the function instead of following the call.
+		boost::optional<unsigned> parameters;
+		if (m_functions && item == AssemblyItem(Instruction::JUMP) && jumpTags.size() == 1)
+			parameters = m_functions->parameters(*jumpTags.begin());
+		if (
+			parameters &&
+			m_tagPositions->count(*jumpTags.begin()) &&
+			!m_activeFunctions.count(*jumpTags.begin()) &&
+			!gas.isInfinite
+		)
+		{
+			set<u256> returnTags = state->tagsInExpression(state->relativeStackElement(-int(*parameters)));
+			shared_ptr<FunctionGasSummary const> summary;
+			if (returnTags.size() == 1 && m_tagPositions->count(*returnTags.begin()))
+				summary = functionSummary(
+					*jumpTags.begin(),
+					meter.largestMemoryAccess(),
+					knownArguments(*state, *parameters)
+				);
+			if (summary && summary->usable)
+			{
+				if (m_summary)
+				{
+					m_summary->memoryWrites.insert(summary->memoryWrites.begin(), summary->memoryWrites.end());
+					m_summary->writesStorage = m_summary->writesStorage || summary->writesStorage;
+				}
+				auto newPath = unique_ptr<GasPath>(new GasPath());
+				newPath->index = m_tagPositions->at(*returnTags.begin());
+				newPath->gas = gas;
+				newPath->gas += summary->returningGas;
+				newPath->largestMemoryAccess = max(meter.largestMemoryAccess(), summary->largestMemoryAccess);
+				newPath->state = state->copy();
+				newPath->state->replaceStackTop(int(*parameters) + 1, summary->returnSlots);
+				if (summary->writesStorage)
+					newPath->state->resetStorage();
+				for (u256 const& slot: summary->memoryWrites)
+					newPath->state->resetMemoryAt(slot);
+				newPath->visitedJumpdests = path->visitedJumpdests;
+				queue(move(newPath));
+				// The paths that stop inside the function.
+				gas += summary->gas;
+				break;
+			}
+		}
+
 		for (u256 const& tag: jumpTags)
 		{
+			if (m_summary && tag == c_returnTag)
+			{
+				recordReturn(gas, *state, meter.largestMemoryAccess());
+				continue;
+			}
 			auto newPath = unique_ptr<GasPath>(new GasPath());
 			newPath->index = m_items.size();
-			if (m_tagPositions.count(tag))
-				newPath->index = m_tagPositions.at(tag);
+			if (m_tagPositions->count(tag))
+				newPath->index = m_tagPositions->at(tag);
 			newPath->gas = gas;
 			newPath->largestMemoryAccess = meter.largestMemoryAccess();
 			newPath->state = state->copy();
@@ -137,3 +296,52 @@ GasMeter::GasConsumption PathGasMeter::handleQueueItem()
 
 	return gas;
 }
+
+AssemblyItems PathGasMeter::knownArguments(KnownState& _state, unsigned _parameters)
+{
+	AssemblyItems arguments;
+	for (int offset = int(_parameters) - 1; offset >= 0; --offset)
+	{
+		ExpressionClasses::Id argument = _state.relativeStackElement(-offset);
+		set<u256> tags = _state.tagsInExpression(argument);
+		if (auto value = _state.expressionClasses().knownConstant(argument))
+			arguments.emplace_back(*value);
+		else if (tags.size() == 1)
+			arguments.emplace_back(PushTag, *tags.begin());
+		else
+			arguments.emplace_back(UndefinedItem);
+	}
+	return arguments;
+}
+
+void PathGasMeter::recordEffects(AssemblyItem const& _item, KnownState& _state)
+{
+	if (_item.type() != Operation)
+		return;
+	Instruction instruction = _item.instruction();
+	if (instruction == Instruction::MSTORE || instruction == Instruction::MSTORE8)
+	{
+		if (auto slot = _state.expressionClasses().knownConstant(_state.relativeStackElement(0)))
+			m_summary->memoryWrites.insert(*slot);
+		else
+			m_summary->usable = false;
+	}
+	else if (SemanticInformation::invalidatesMemory(instruction))
+		m_summary->usable = false;
+	if (SemanticInformation::invalidatesStorage(instruction))
+		m_summary->writesStorage = true;
+}
+
+void PathGasMeter::recordReturn(
+	GasMeter::GasConsumption const& _gas,
+	KnownState const& _state,
+	u256 const& _largestMemoryAccess
+)
+{
+	// The return address was at height one and is removed by the jump.
+	if (m_summary->returnSlots >= 0 && m_summary->returnSlots != _state.stackHeight())
+		m_summary->usable = false;
+	m_summary->returnSlots = _state.stackHeight();
+	m_summary->returningGas = max(m_summary->returningGas, _gas);
+	m_summary->largestMemoryAccess = max(m_summary->largestMemoryAccess, _largestMemoryAccess);
+}
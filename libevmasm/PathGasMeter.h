@@ -25,9 +25,14 @@
 
 #include <libsolidity/interface/EVMVersion.h>
 
+#include <boost/optional.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <tuple>
 #include <vector>
-#include <memory>
 
 namespace dev
 {
@@ -45,15 +50,84 @@ struct GasPath
 	std::set<size_t> visitedJumpdests;
 };
 
+/**
+ * Gas usage and effects of an internal function from its entry up to the jump back to its
+ * caller, computed by PathGasMeter for a certain largest memory access and certain known
+ * arguments at the time of the call.
+ */
+struct FunctionGasSummary
+{
+	/// Upper bound on the gas of all paths through the function, including the ones that stop.
+	GasMeter::GasConsumption gas;
+	/// Upper bound on the gas of the paths that return to the caller.
+	GasMeter::GasConsumption returningGas;
+	/// Number of stack slots that replace the arguments and the return address.
+	int returnSlots = -1;
+	u256 largestMemoryAccess;
+	/// Constant positions the function might store to in memory.
+	std::set<u256> memoryWrites;
+	bool writesStorage = false;
+	/// False if the summary cannot replace the function body, e.g. because it writes to memory
+	/// at unknown positions or its gas usage is not bounded.
+	bool usable = true;
+	/// Number of items visited to compute the summary, including nested summaries.
+	size_t visitedItems = 0;
+};
+
+/**
+ * Internal functions of a list of AssemblyItems that PathGasMeter summarises instead of following
+ * every call into their bodies. The summaries are computed on first use and shared between all
+ * meters on these items, also across threads.
+ */
+class FunctionGasSummaries
+{
+public:
+	/// @returns the positions of the tags in the given items.
+	static std::shared_ptr<std::map<u256, size_t> const> tagPositions(AssemblyItems const& _items);
+
+	explicit FunctionGasSummaries(AssemblyItems const& _items): m_tagPositions(tagPositions(_items)) {}
+
+	/// @returns the positions of the tags in the items the functions belong to.
+	std::shared_ptr<std::map<u256, size_t> const> const& tagPositions() const { return m_tagPositions; }
+	/// Registers the function starting at the tag @a _entryTag, which expects the return address
+	/// below @a _parameters stack slots.
+	void registerFunction(u256 const& _entryTag, unsigned _parameters);
+	/// @returns the number of parameter slots if @a _tag is the entry of a registered function.
+	boost::optional<unsigned> parameters(u256 const& _tag) const;
+
+	/// Identifies a summary by the entry tag, the largest memory access and the arguments, given
+	/// as the items that push them if they are known and as UndefinedItem otherwise.
+	using Key = std::tuple<u256, u256, AssemblyItems>;
+	std::shared_ptr<FunctionGasSummary const> summary(Key const& _key) const;
+	void storeSummary(Key const& _key, std::shared_ptr<FunctionGasSummary const> const& _summary);
+
+private:
+	std::shared_ptr<std::map<u256, size_t> const> m_tagPositions;
+	mutable std::mutex m_mutex;
+	std::map<u256, unsigned> m_parameters;
+	std::map<Key, std::shared_ptr<FunctionGasSummary const>> m_summaries;
+};
+
 /**
  * Computes an upper bound on the gas usage of a computation starting at a certain position in
  * a list of AssemblyItems in a given state until the computation stops.
  * Can be used to estimate the gas usage of functions on any given input.
+ * Calls to functions registered in the given FunctionGasSummaries are replaced by their summaries
+ * where possible.
  */
 class PathGasMeter
 {
 public:
-	explicit PathGasMeter(AssemblyItems const& _items, solidity::EVMVersion _evmVersion);
+	/// Default for the number of items a meter visits, including the items visited to summarise
+	/// the functions it calls, before it gives up and reports infinite gas.
+	static size_t const defaultExplorationBudget = 1000000;
+
+	explicit PathGasMeter(
+		AssemblyItems const& _items,
+		solidity::EVMVersion _evmVersion,
+		FunctionGasSummaries* _functions = nullptr,
+		size_t _explorationBudget = defaultExplorationBudget
+	);
 
 	GasMeter::GasConsumption estimateMax(size_t _startIndex, std::shared_ptr<KnownState> const& _state);
 
@@ -61,12 +135,23 @@ public:
 		AssemblyItems const& _items,
 		solidity::EVMVersion _evmVersion,
 		size_t _startIndex,
-		std::shared_ptr<KnownState> const& _state
+		std::shared_ptr<KnownState> const& _state,
+		FunctionGasSummaries* _functions = nullptr
 	)
 	{
-		return PathGasMeter(_items, _evmVersion).estimateMax(_startIndex, _state);
+		return PathGasMeter(_items, _evmVersion, _functions).estimateMax(_startIndex, _state);
 	}
 
+	/// @returns the summary of the registered function starting at @a _entryTag if called with
+	/// the given largest memory access and arguments, computes it if it is not yet known.
+	/// @param _arguments the items pushing the arguments, UndefinedItem for unknown ones and
+	/// all unknown if empty.
+	std::shared_ptr<FunctionGasSummary const> functionSummary(
+		u256 const& _entryTag,
+		u256 const& _largestMemoryAccess,
+		AssemblyItems _arguments = AssemblyItems()
+	);
+
 private:
 	/// Adds a new path item to the queue, but only if we do not already have
 	/// a higher gas usage at that point.
@@ -74,14 +159,32 @@ private:
 	/// point in time, but it greatly reduces computational overhead.
 	void queue(std::unique_ptr<GasPath>&& _newPath);
 	GasMeter::GasConsumption handleQueueItem();
+	/// @returns the items pushing the topmost @a _parameters stack elements if they are known
+	/// constants or tags and UndefinedItem otherwise.
+	static AssemblyItems knownArguments(KnownState& _state, unsigned _parameters);
+	/// Records the effect of @a _item on memory and storage in the summary under construction.
+	void recordEffects(AssemblyItem const& _item, KnownState& _state);
+	/// Records a path that returns from the function whose summary is under construction.
+	void recordReturn(GasMeter::GasConsumption const& _gas, KnownState const& _state, u256 const& _largestMemoryAccess);
 
 	/// Map of jumpdest -> gas path, so not really a queue. We only have one queued up
 	/// item per jumpdest, because of the behaviour of `queue` above.
 	std::map<size_t, std::unique_ptr<GasPath>> m_queue;
 	std::map<size_t, GasMeter::GasConsumption> m_highestGasUsagePerJumpdest;
-	std::map<u256, size_t> m_tagPositions;
+	std::shared_ptr<std::map<u256, size_t> const> m_tagPositions;
 	AssemblyItems const& m_items;
 	solidity::EVMVersion m_evmVersion;
+	FunctionGasSummaries* m_functions = nullptr;
+	size_t m_explorationBudget;
+	/// Number of items visited by this meter and the meters it started for function summaries,
+	/// shared with them so that the budget applies to the whole estimation. Summaries taken from
+	/// the cache count as if they were computed again, so the result does not depend on the cache.
+	std::shared_ptr<size_t> m_visitedItems = std::make_shared<size_t>(0);
+	/// Functions whose summaries are computed by this meter or the meters that started it.
+	/// Calls to them are followed instead, which is how recursion was handled before.
+	std::set<u256> m_activeFunctions;
+	/// The summary computed by this meter, if any.
+	std::shared_ptr<FunctionGasSummary> m_summary;
 };
 
 }
@@ -33,13 +33,20 @@ using namespace dev;
 namespace
 {
 
+/// Maximum number of items (apart from the unbounded UnreachableCode) a rule looks at.
+size_t const c_maxWindowSize = 3;
+
 struct OptimiserState
 {
-	AssemblyItems const& items;
-	size_t i;
+	/// Items that still have to be examined in reverse order, i.e. the next item is the last one.
+	AssemblyItems const& pending;
+	/// Number of pending items replaced by the rule that matched.
+	size_t consumed;
 	std::back_insert_iterator<AssemblyItems> out;
 };
 
+using PendingIterator = AssemblyItems::const_reverse_iterator;
+
 template <class Method, size_t Arguments>
 struct ApplyRule
 {
@@ -47,7 +54,7 @@ struct ApplyRule
 template <class Method>
 struct ApplyRule<Method, 3>
 {
-	static bool applyRule(AssemblyItems::const_iterator _in, std::back_insert_iterator<AssemblyItems> _out)
+	static bool applyRule(PendingIterator _in, std::back_insert_iterator<AssemblyItems> _out)
 	{
 		return Method::applySimple(_in[0], _in[1], _in[2], _out);
 	}
@@ -55,7 +62,7 @@ struct ApplyRule<Method, 3>
 template <class Method>
 struct ApplyRule<Method, 2>
 {
-	static bool applyRule(AssemblyItems::const_iterator _in, std::back_insert_iterator<AssemblyItems> _out)
+	static bool applyRule(PendingIterator _in, std::back_insert_iterator<AssemblyItems> _out)
 	{
 		return Method::applySimple(_in[0], _in[1], _out);
 	}
@@ -63,7 +70,7 @@ struct ApplyRule<Method, 2>
 template <class Method>
 struct ApplyRule<Method, 1>
 {
-	static bool applyRule(AssemblyItems::const_iterator _in, std::back_insert_iterator<AssemblyItems> _out)
+	static bool applyRule(PendingIterator _in, std::back_insert_iterator<AssemblyItems> _out)
 	{
 		return Method::applySimple(_in[0], _out);
 	}
@@ -75,11 +82,11 @@ struct SimplePeepholeOptimizerMethod
 	static bool apply(OptimiserState& _state)
 	{
 		if (
-			_state.i + WindowSize <= _state.items.size() &&
-			ApplyRule<Method, WindowSize>::applyRule(_state.items.begin() + _state.i, _state.out)
+			WindowSize <= _state.pending.size() &&
+			ApplyRule<Method, WindowSize>::applyRule(_state.pending.rbegin(), _state.out)
 		)
 		{
-			_state.i += WindowSize;
+			_state.consumed = WindowSize;
 			return true;
 		}
 		else
@@ -87,15 +94,6 @@ struct SimplePeepholeOptimizerMethod
 	}
 };
 
-struct Identity: SimplePeepholeOptimizerMethod<Identity, 1>
-{
-	static bool applySimple(AssemblyItem const& _item, std::back_insert_iterator<AssemblyItems> _out)
-	{
-		*_out = _item;
-		return true;
-	}
-};
-
 struct PushPop: SimplePeepholeOptimizerMethod<PushPop, 2>
 {
 	static bool applySimple(AssemblyItem const& _push, AssemblyItem const& _pop, std::back_insert_iterator<AssemblyItems>)
@@ -177,7 +175,7 @@ struct SwapComparison: SimplePeepholeOptimizerMethod<SwapComparison, 2>
 {
 	static bool applySimple(AssemblyItem const& _swap, AssemblyItem const& _op, std::back_insert_iterator<AssemblyItems> _out)
 	{
-		map<Instruction, Instruction> swappableOps{
+		static map<Instruction, Instruction> const swappableOps{
 			{ Instruction::LT, Instruction::GT },
 			{ Instruction::GT, Instruction::LT },
 			{ Instruction::SLT, Instruction::SGT },
@@ -271,8 +269,8 @@ struct UnreachableCode
 {
 	static bool apply(OptimiserState& _state)
 	{
-		auto it = _state.items.begin() + _state.i;
-		auto end = _state.items.end();
+		auto it = _state.pending.rbegin();
+		auto end = _state.pending.rend();
 		if (it == end)
 			return false;
 		if (
@@ -291,7 +289,7 @@ struct UnreachableCode
 		if (i > 1)
 		{
 			*_state.out = it[0];
-			_state.i += i;
+			_state.consumed = i;
 			return true;
 		}
 		else
@@ -299,16 +297,16 @@ struct UnreachableCode
 	}
 };
 
-void applyMethods(OptimiserState&)
+bool applyMethods(OptimiserState&)
 {
-	assertThrow(false, OptimizerException, "Peephole optimizer failed to apply identity.");
+	return false;
 }
 
+/// Applies the first of the given methods that matches at the next pending item.
 template <typename Method, typename... OtherMethods>
-void applyMethods(OptimiserState& _state, Method, OtherMethods... _other)
+bool applyMethods(OptimiserState& _state, Method, OtherMethods... _other)
 {
-	if (!Method::apply(_state))
-		applyMethods(_state, _other...);
+	return Method::apply(_state) || applyMethods(_state, _other...);
 }
 
 size_t numberOfPops(AssemblyItems const& _items)
@@ -320,9 +318,33 @@ size_t numberOfPops(AssemblyItems const& _items)
 
 bool PeepholeOptimiser::optimise()
 {
-	OptimiserState state {m_items, 0, std::back_inserter(m_optimisedItems)};
-	while (state.i < m_items.size())
-		applyMethods(state, PushPop(), OpPop(), DoublePush(), DoubleSwap(), CommutativeSwap(), SwapComparison(), JumpToNext(), UnreachableCode(), TagConjunctions(), TruthyAnd(), Identity());
+	// The items are examined from front to back. The result of a rewrite is examined again,
+	// together with the items before it that could now form a match with it. Since every
+	// rewrite makes the code cheaper, this reaches a fixed point in a single call.
+	m_optimisedItems.clear();
+	m_optimisedItems.reserve(m_items.size());
+	AssemblyItems pending(m_items.rbegin(), m_items.rend());
+	AssemblyItems replacement;
+	while (!pending.empty())
+	{
+		replacement.clear();
+		OptimiserState state{pending, 0, back_inserter(replacement)};
+		if (applyMethods(state, PushPop(), OpPop(), DoublePush(), DoubleSwap(), CommutativeSwap(), SwapComparison(), JumpToNext(), UnreachableCode(), TagConjunctions(), TruthyAnd()))
+		{
+			pending.erase(pending.end() - state.consumed, pending.end());
+			pending.insert(pending.end(), replacement.rbegin(), replacement.rend());
+			for (size_t i = 1; i < c_maxWindowSize && !m_optimisedItems.empty(); ++i)
+			{
+				pending.push_back(move(m_optimisedItems.back()));
+				m_optimisedItems.pop_back();
+			}
+		}
+		else
+		{
+			m_optimisedItems.push_back(move(pending.back()));
+			pending.pop_back();
+		}
+	}
 	if (m_optimisedItems.size() < m_items.size() || (
 		m_optimisedItems.size() == m_items.size() && (
 			eth::bytesRequired(m_optimisedItems, 3) < eth::bytesRequired(m_items, 3) ||
@@ -126,6 +126,8 @@ std::vector<SimplificationRule<Pattern>> simplificationRuleListPart1(
 		{{Instruction::XOR, {0, X}}, [=]{ return X; }, false},
 		{{Instruction::MOD, {X, 0}}, [=]{ return u256(0); }, true},
 		{{Instruction::MOD, {0, X}}, [=]{ return u256(0); }, true},
+		{{Instruction::SHL, {0, X}}, [=]{ return X; }, false},
+		{{Instruction::SHR, {0, X}}, [=]{ return X; }, false},
 		{{Instruction::EQ, {X, 0}}, [=]() -> Pattern { return {Instruction::ISZERO, {X}}; }, false },
 		{{Instruction::EQ, {0, X}}, [=]() -> Pattern { return {Instruction::ISZERO, {X}}; }, false },
 
@@ -32,8 +32,9 @@
 #include <boost/range/adaptor/reversed.hpp>
 #include <boost/noncopyable.hpp>
 
-#include <utility>
+#include <array>
 #include <functional>
+#include <utility>
 
 using namespace std;
 using namespace dev;
@@ -48,15 +49,61 @@ SimplificationRule<Pattern> const* Rules::findFirstMatch(
 	resetMatchGroups();
 
 	assertThrow(_expr.item, OptimizerException, "");
-	for (auto const& rule: m_rules[byte(_expr.item->instruction())])
+	for (auto const* rule: candidateRules(_expr, _classes))
 	{
-		if (rule.pattern.matches(_expr, _classes))
-			return &rule;
+		if (rule->pattern.matches(_expr, _classes))
+			return rule;
 		resetMatchGroups();
 	}
 	return nullptr;
 }
 
+vector<SimplificationRule<Pattern> const*> const& Rules::candidateRules(
+	Expression const& _expr,
+	ExpressionClasses const& _classes
+)
+{
+	// The key consists of the instruction and, for each argument, its type and instruction
+	// in twelve bits. Expressions with more arguments share the key of their instruction.
+	size_t const maxArguments = 4;
+	uint64_t key = byte(_expr.item->instruction());
+	array<AssemblyItem const*, maxArguments> argumentItems;
+	size_t argumentCount = _expr.arguments.size() <= maxArguments ? _expr.arguments.size() : 0;
+	for (size_t i = 0; i < argumentCount; ++i)
+	{
+		AssemblyItem const* item = _classes.representative(_expr.arguments[i]).item;
+		argumentItems[i] = item;
+		uint64_t kind = 0xfff;
+		if (item)
+			kind = (uint64_t(item->type()) << 8) | (item->type() == Operation ? byte(item->instruction()) : 0);
+		key = (key << 12) | kind;
+	}
+
+	auto cached = m_candidateRules.find(key);
+	if (cached != m_candidateRules.end())
+		return cached->second;
+
+	vector<SimplificationRule<Pattern> const*>& candidates = m_candidateRules[key];
+	for (auto const& rule: m_rules[byte(_expr.item->instruction())])
+	{
+		vector<Pattern> const& argumentPatterns = rule.pattern.arguments();
+		bool possible = true;
+		for (size_t i = 0; possible && i < argumentPatterns.size() && i < argumentCount; ++i)
+		{
+			Pattern const& pattern = argumentPatterns[i];
+			AssemblyItem const* item = argumentItems[i];
+			if (pattern.type() != UndefinedItem)
+				possible =
+					item &&
+					item->type() == pattern.type() &&
+					(pattern.type() != Operation || item->instruction() == pattern.instruction());
+		}
+		if (possible)
+			candidates.push_back(&rule);
+	}
+	return candidates;
+}
+
 bool Rules::isInitialized() const
 {
 	return !m_rules[byte(Instruction::ADD)].empty();
@@ -100,10 +147,13 @@ Pattern::Pattern(Instruction _instruction, std::vector<Pattern> const& _argument
 {
 }
 
-void Pattern::setMatchGroup(unsigned _group, map<unsigned, Expression const*>& _matchGroups)
+void Pattern::setMatchGroup(unsigned _group, MatchGroups& _matchGroups)
 {
+	assertThrow(_group > 0, OptimizerException, "");
 	m_matchGroup = _group;
 	m_matchGroups = &_matchGroups;
+	if (_matchGroups.size() <= _group)
+		_matchGroups.resize(_group + 1, nullptr);
 }
 
 bool Pattern::matches(Expression const& _expr, ExpressionClasses const& _classes) const
@@ -112,9 +162,10 @@ bool Pattern::matches(Expression const& _expr, ExpressionClasses const& _classes
 		return false;
 	if (m_matchGroup)
 	{
-		if (!m_matchGroups->count(m_matchGroup))
-			(*m_matchGroups)[m_matchGroup] = &_expr;
-		else if ((*m_matchGroups)[m_matchGroup]->id != _expr.id)
+		Expression const*& matched = (*m_matchGroups)[m_matchGroup];
+		if (!matched)
+			matched = &_expr;
+		else if (matched->id != _expr.id)
 			return false;
 	}
 	assertThrow(m_arguments.size() == 0 || _expr.arguments.size() == m_arguments.size(), OptimizerException, "");
@@ -28,7 +28,9 @@
 
 #include <boost/noncopyable.hpp>
 
+#include <algorithm>
 #include <functional>
+#include <unordered_map>
 #include <vector>
 
 namespace dev
@@ -38,6 +40,10 @@ namespace eth
 
 class Pattern;
 
+/// Expressions matched by the patterns of a rule, indexed by their match group.
+/// Match groups start at one, entries of groups that did not match yet are nullptr.
+using MatchGroups = std::vector<ExpressionClasses::Expression const*>;
+
 /**
  * Container for all simplification rules.
  */
@@ -49,7 +55,8 @@ public:
 	Rules();
 
 	/// @returns a pointer to the first matching pattern and sets the match
-	/// groups accordingly.
+	/// groups accordingly. Only tries the rules whose arguments can match the kinds of
+	/// the arguments of @a _expr (see candidateRules).
 	SimplificationRule<Pattern> const* findFirstMatch(
 		Expression const& _expr,
 		ExpressionClasses const& _classes
@@ -63,12 +70,23 @@ private:
 	void addRules(std::vector<SimplificationRule<Pattern>> const& _rules);
 	void addRule(SimplificationRule<Pattern> const& _rule);
 
-	void resetMatchGroups() { m_matchGroups.clear(); }
+	/// @returns the rules for the instruction of @a _expr, in order, without those rules
+	/// that cannot match because the type or instruction of one of their argument patterns
+	/// differs from that of the respective argument of @a _expr. The result is cached per
+	/// combination of instruction and argument kinds.
+	std::vector<SimplificationRule<Pattern> const*> const& candidateRules(
+		Expression const& _expr,
+		ExpressionClasses const& _classes
+	);
+
+	void resetMatchGroups() { std::fill(m_matchGroups.begin(), m_matchGroups.end(), nullptr); }
 
-	std::map<unsigned, Expression const*> m_matchGroups;
+	MatchGroups m_matchGroups;
 	/// Pattern to match, replacement to be applied and flag indicating whether
 	/// the replacement might remove some elements (except constants).
 	std::vector<SimplificationRule<Pattern>> m_rules[256];
+	/// Cache for candidateRules.
+	std::unordered_map<uint64_t, std::vector<SimplificationRule<Pattern> const*>> m_candidateRules;
 };
 
 /**
@@ -93,17 +111,17 @@ public:
 	/// Sets this pattern to be part of the match group with the identifier @a _group.
 	/// Inside one rule, all patterns in the same match group have to match expressions from the
 	/// same expression equivalence class.
-	void setMatchGroup(unsigned _group, std::map<unsigned, Expression const*>& _matchGroups);
+	void setMatchGroup(unsigned _group, MatchGroups& _matchGroups);
 	unsigned matchGroup() const { return m_matchGroup; }
 	bool matches(Expression const& _expr, ExpressionClasses const& _classes) const;
 
 	AssemblyItem toAssemblyItem(SourceLocation const& _location) const;
-	std::vector<Pattern> arguments() const { return m_arguments; }
+	std::vector<Pattern> const& arguments() const { return m_arguments; }
 
 	/// @returns the id of the matched expression if this pattern is part of a match group.
 	Id id() const { return matchGroupValue().id; }
 	/// @returns the data of the matched expression if this pattern is part of a match group.
-	u256 const& d() const { return matchGroupValue().item->data(); }
+	u256 d() const { return matchGroupValue().item->data(); }
 
 	std::string toString() const;
 
@@ -125,7 +143,7 @@ private:
 	std::shared_ptr<u256> m_data; ///< Only valid if m_type is not Operation
 	std::vector<Pattern> m_arguments;
 	unsigned m_matchGroup = 0;
-	std::map<unsigned, Expression const*>* m_matchGroups = nullptr;
+	MatchGroups* m_matchGroups = nullptr;
 };
 
 /**
@@ -0,0 +1,37 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Table of the source names referenced by source locations.
+ */
+
+#include <libevmasm/SourceLocation.h>
+
+#include <mutex>
+#include <unordered_set>
+
+using namespace std;
+using namespace dev;
+
+string const* dev::internSourceName(string const& _sourceName)
+{
+	static mutex s_mutex;
+	// Elements of an unordered_set keep their address when the set is rehashed.
+	// Never cleared, see the documentation in the header.
+	static unordered_set<string> s_sourceNames;
+	lock_guard<mutex> lock(s_mutex);
+	return &*s_sourceNames.insert(_sourceName).first;
+}
@@ -22,7 +22,6 @@
 
 #pragma once
 
-#include <memory>
 #include <string>
 #include <ostream>
 #include <tuple>
@@ -31,34 +30,31 @@
 namespace dev
 {
 
+/// @returns the unique copy of @a _sourceName that is shared by all source locations.
+/// Interned names are kept for the lifetime of the process, so that locations can refer to them
+/// by pointer, and two locations refer to the same source exactly if their pointers are equal.
+/// They cannot be released per compilation, because syntax trees and code snippets that contain
+/// locations are reused across compilations (e.g. by incremental parsing). The table therefore
+/// grows with the number of distinct source names a process sees, not with the number of
+/// compilations, which keeps it small for a long-running process that compiles the same files.
+/// Safe to call from multiple threads.
+std::string const* internSourceName(std::string const& _sourceName);
+
 /**
  * Representation of an interval of source positions.
  * The interval includes start and excludes end.
+ * The source name is interned (see internSourceName), so copying and comparing locations does
+ * not touch the name itself.
  */
 struct SourceLocation
 {
-	SourceLocation(): start(-1), end(-1) { }
-	SourceLocation(int _start, int _end, std::shared_ptr<std::string const> _sourceName):
+	SourceLocation(): start(-1), end(-1), sourceName(nullptr) { }
+	SourceLocation(int _start, int _end, std::string const* _sourceName):
 		start(_start), end(_end), sourceName(_sourceName) { }
-	SourceLocation(SourceLocation&& _other) noexcept:
-		start(_other.start),
-		end(_other.end),
-		sourceName(std::move(_other.sourceName))
-	{}
-	SourceLocation(SourceLocation const&) = default;
-	SourceLocation& operator=(SourceLocation const&) = default;
-	SourceLocation& operator=(SourceLocation&& _other) noexcept
-	{
-		start = _other.start;
-		end = _other.end;
-		sourceName = std::move(_other.sourceName);
-		return *this;
-	}
 
 	bool operator==(SourceLocation const& _other) const
 	{
-		return start == _other.start && end == _other.end &&
-			((!sourceName && !_other.sourceName) || (sourceName && _other.sourceName && *sourceName == *_other.sourceName));
+		return start == _other.start && end == _other.end && sourceName == _other.sourceName;
 	}
 	bool operator!=(SourceLocation const& _other) const { return !operator==(_other); }
 	inline bool operator<(SourceLocation const& _other) const;
@@ -69,7 +65,8 @@ struct SourceLocation
 
 	int start;
 	int end;
-	std::shared_ptr<std::string const> sourceName;
+	/// Interned source name or nullptr.
+	std::string const* sourceName;
 };
 
 /// Stream output for Location (used e.g. in boost exceptions).
@@ -82,22 +79,24 @@ inline std::ostream& operator<<(std::ostream& _out, SourceLocation const& _locat
 
 bool SourceLocation::operator<(SourceLocation const& _other) const
 {
-	if (!sourceName || !_other.sourceName)
-		return std::make_tuple(int(!!sourceName), start, end) < std::make_tuple(int(!!_other.sourceName), _other.start, _other.end);
+	if (sourceName == _other.sourceName)
+		return std::make_tuple(start, end) < std::make_tuple(_other.start, _other.end);
+	else if (!sourceName || !_other.sourceName)
+		return !sourceName;
 	else
-		return std::make_tuple(*sourceName, start, end) < std::make_tuple(*_other.sourceName, _other.start, _other.end);
+		return *sourceName < *_other.sourceName;
 }
 
 bool SourceLocation::contains(SourceLocation const& _other) const
 {
-	if (isEmpty() || _other.isEmpty() || ((!sourceName || !_other.sourceName || *sourceName != *_other.sourceName) && (sourceName || _other.sourceName)))
+	if (isEmpty() || _other.isEmpty() || sourceName != _other.sourceName)
 		return false;
 	return start <= _other.start && _other.end <= end;
 }
 
 bool SourceLocation::intersects(SourceLocation const& _other) const
 {
-	if (isEmpty() || _other.isEmpty() || ((!sourceName || !_other.sourceName || *sourceName != *_other.sourceName) && (sourceName || _other.sourceName)))
+	if (isEmpty() || _other.isEmpty() || sourceName != _other.sourceName)
 		return false;
 	return _other.start < end && start < _other.end;
 }
@@ -39,7 +39,8 @@ SimplificationRule<Pattern> const* SimplificationRules::findFirstMatch(Expressio
 	if (_expr.type() != typeid(FunctionalInstruction))
 		return nullptr;
 
-	static SimplificationRules rules;
+	// The rules store the match groups of the current match, so they cannot be shared between threads.
+	static thread_local SimplificationRules rules;
 	assertThrow(rules.isInitialized(), OptimizerException, "Rule list not properly initialized.");
 
 	FunctionalInstruction const& instruction = boost::get<FunctionalInstruction>(_expr);
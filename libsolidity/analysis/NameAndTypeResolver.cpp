@@ -492,8 +492,7 @@ bool DeclarationRegistrationHelper::registerDeclaration(
 		solAssert(conflictingDeclaration, "");
 		bool const comparable =
 			_errorLocation->sourceName &&
-			conflictingDeclaration->location().sourceName &&
-			*_errorLocation->sourceName == *conflictingDeclaration->location().sourceName;
+			_errorLocation->sourceName == conflictingDeclaration->location().sourceName;
 		if (comparable && _errorLocation->start < conflictingDeclaration->location().start)
 		{
 			firstDeclarationLocation = *_errorLocation;
@@ -38,15 +38,21 @@ using namespace dev::solidity;
 class IDDispenser
 {
 public:
-	static size_t next() { return ++instance(); }
-	static void reset() { instance() = 0; }
+	static size_t next() { return ++counter(); }
+	static void reset() { counter() = 0; }
+	/// @returns the counter set by the innermost ASTNodeIDScope on this thread or nullptr.
+	static size_t*& activeCounter()
+	{
+		static thread_local size_t* active = nullptr;
+		return active;
+	}
 private:
-	static size_t& instance()
+	static size_t& counter()
 	{
-		static IDDispenser dispenser;
-		return dispenser.id;
+		static thread_local size_t defaultCounter = 0;
+		size_t* active = activeCounter();
+		return active ? *active : defaultCounter;
 	}
-	size_t id = 0;
 };
 
 ASTNode::ASTNode(SourceLocation const& _location):
@@ -65,6 +71,23 @@ void ASTNode::resetID()
 	IDDispenser::reset();
 }
 
+ASTNodeIDScope::ASTNodeIDScope(size_t& _counter):
+	m_previousCounter(IDDispenser::activeCounter())
+{
+	IDDispenser::activeCounter() = &_counter;
+}
+
+ASTNodeIDScope::~ASTNodeIDScope()
+{
+	IDDispenser::activeCounter() = m_previousCounter;
+}
+
+void ASTNode::clearAnalysis()
+{
+	delete m_annotation;
+	m_annotation = nullptr;
+}
+
 ASTAnnotation& ASTNode::annotation() const
 {
 	if (!m_annotation)
@@ -240,6 +263,14 @@ vector<Declaration const*> const& ContractDefinition::inheritableMembers() const
 	return *m_inheritableMembers;
 }
 
+void ContractDefinition::clearAnalysis()
+{
+	ASTNode::clearAnalysis();
+	m_interfaceFunctionList.reset();
+	m_interfaceEvents.reset();
+	m_inheritableMembers.reset();
+}
+
 TypePointer ContractDefinition::type() const
 {
 	return make_shared<TypeType>(make_shared<ContractType>(*this));
@@ -63,9 +63,13 @@ public:
 
 	/// @returns an identifier of this AST node that is unique for a single compilation run.
 	size_t id() const { return m_id; }
-	/// Resets the global ID counter. This invalidates all previous IDs.
+	/// Resets the ID counter that is active on the current thread. This invalidates all previous IDs.
 	static void resetID();
 
+	/// Removes the annotation and all other information about this node that is computed
+	/// during analysis, so that the node can be analysed again. Child nodes are not affected.
+	virtual void clearAnalysis();
+
 	virtual void accept(ASTVisitor& _visitor) = 0;
 	virtual void accept(ASTConstVisitor& _visitor) const = 0;
 	template <class T>
@@ -107,6 +111,21 @@ private:
 	SourceLocation m_location;
 };
 
+/**
+ * While an object of this class is alive, all AST nodes created on the current thread
+ * take their IDs from the given counter. This allows independent compilations to run
+ * concurrently, each with its own sequence of IDs. Scopes can be nested.
+ */
+class ASTNodeIDScope: private boost::noncopyable
+{
+public:
+	explicit ASTNodeIDScope(size_t& _counter);
+	~ASTNodeIDScope();
+
+private:
+	size_t* m_previousCounter = nullptr;
+};
+
 template <class _T>
 std::vector<_T const*> ASTNode::filteredNodes(std::vector<ASTPointer<ASTNode>> const& _nodes)
 {
@@ -410,6 +429,7 @@ public:
 	virtual TypePointer type() const override;
 
 	virtual ContractDefinitionAnnotation& annotation() const override;
+	virtual void clearAnalysis() override;
 
 	ContractKind contractKind() const { return m_contractKind; }
 
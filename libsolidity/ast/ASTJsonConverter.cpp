@@ -25,6 +25,7 @@
 #include <libsolidity/ast/AST.h>
 #include <libsolidity/inlineasm/AsmData.h>
 #include <libsolidity/inlineasm/AsmPrinter.h>
+#include <algorithm>
 
 using namespace std;
 
@@ -453,16 +454,25 @@ bool ASTJsonConverter::visit(ArrayTypeName const& _node)
 
 bool ASTJsonConverter::visit(InlineAssembly const& _node)
 {
-	Json::Value externalReferences(Json::arrayValue);
+	// The annotation is ordered by the addresses of the identifiers, which differ
+	// between runs. Sort the references by their position in the source instead.
+	vector<pair<int, Json::Value>> references;
 	for (auto const& it : _node.annotation().externalReferences)
 	{
 		if (it.first)
 		{
 			Json::Value tuple(Json::objectValue);
 			tuple[it.first->name] = inlineAssemblyIdentifierToJson(it);
-			externalReferences.append(tuple);
+			references.emplace_back(it.first->location.start, std::move(tuple));
 		}
 	}
+	sort(references.begin(), references.end(), [](pair<int, Json::Value> const& _a, pair<int, Json::Value> const& _b)
+	{
+		return _a.first < _b.first;
+	});
+	Json::Value externalReferences(Json::arrayValue);
+	for (auto& reference: references)
+		externalReferences.append(std::move(reference.second));
 	setJsonNode(_node, "InlineAssembly", {
 		make_pair("operations", Json::Value(assembly::AsmPrinter()(_node.operations()))),
 		make_pair("externalReferences", std::move(externalReferences))
@@ -25,6 +25,7 @@
 #include <libsolidity/ast/AST.h>
 #include <libsolidity/codegen/CompilerUtils.h>
 
+#include <libdevcore/Common.h>
 #include <libdevcore/Whiskers.h>
 
 #include <boost/algorithm/string/join.hpp>
@@ -34,6 +35,19 @@ using namespace std;
 using namespace dev;
 using namespace dev::solidity;
 
+shared_ptr<ABIFunctionCache::Function const> ABIFunctionCache::lookup(string const& _name, EVMVersion _evmVersion) const
+{
+	lock_guard<mutex> lock(m_mutex);
+	auto it = m_functions.find(make_pair(_name, _evmVersion));
+	return it == m_functions.end() ? nullptr : it->second;
+}
+
+void ABIFunctionCache::store(string const& _name, EVMVersion _evmVersion, shared_ptr<Function const> const& _function)
+{
+	lock_guard<mutex> lock(m_mutex);
+	m_functions[make_pair(_name, _evmVersion)] = _function;
+}
+
 string ABIFunctions::tupleEncoder(
 	TypePointers const& _givenTypes,
 	TypePointers const& _targetTypes,
@@ -182,6 +196,7 @@ string ABIFunctions::requestedFunctions()
 	for (auto const& f: m_requestedFunctions)
 		result += f.second;
 	m_requestedFunctions.clear();
+	m_cachedFunctions.clear();
 	return result;
 }
 
@@ -1688,15 +1703,52 @@ string ABIFunctions::allocationFunction()
 
 string ABIFunctions::createFunction(string const& _name, function<string ()> const& _creator)
 {
-	if (!m_requestedFunctions.count(_name))
+	if (!m_dependencyStack.empty())
+		m_dependencyStack.back().insert(_name);
+	if (m_requestedFunctions.count(_name))
+		return _name;
+
+	if (m_cache)
+		if (auto cached = m_cache->lookup(_name, m_evmVersion))
+		{
+			addCachedFunction(_name, cached);
+			return _name;
+		}
+
+	m_dependencyStack.emplace_back();
+	ScopeGuard popDependencies([&]() { m_dependencyStack.pop_back(); });
+	auto fun = _creator();
+	solAssert(!fun.empty(), "");
+	m_requestedFunctions[_name] = fun;
+
+	if (m_cache)
 	{
-		auto fun = _creator();
-		solAssert(!fun.empty(), "");
-		m_requestedFunctions[_name] = fun;
+		auto function = make_shared<ABIFunctionCache::Function>();
+		function->code = fun;
+		for (string const& dependency: m_dependencyStack.back())
+		{
+			auto it = m_cachedFunctions.find(dependency);
+			// Do not cache functions that depend on functions which were not cached.
+			if (it == m_cachedFunctions.end())
+				return _name;
+			function->dependencies[dependency] = it->second;
+		}
+		m_cachedFunctions[_name] = function;
+		m_cache->store(_name, m_evmVersion, function);
 	}
 	return _name;
 }
 
+void ABIFunctions::addCachedFunction(string const& _name, shared_ptr<ABIFunctionCache::Function const> const& _function)
+{
+	if (m_requestedFunctions.count(_name))
+		return;
+	m_requestedFunctions[_name] = _function->code;
+	m_cachedFunctions[_name] = _function;
+	for (auto const& dependency: _function->dependencies)
+		addCachedFunction(dependency.first, dependency.second);
+}
+
 size_t ABIFunctions::headSize(TypePointers const& _targetTypes)
 {
 	size_t headSize = 0;
@@ -29,6 +29,9 @@
 #include <vector>
 #include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <set>
 
 namespace dev {
 namespace solidity {
@@ -40,6 +43,31 @@ class FunctionType;
 using TypePointer = std::shared_ptr<Type const>;
 using TypePointers = std::vector<TypePointer>;
 
+/**
+ * Cache of the functions generated by ABIFunctions that is shared by all contracts of
+ * a compilation, so that each function is only generated once. Function names contain
+ * type identifiers, which refer to AST nodes, so the cache must not outlive the AST.
+ * Thread-safe.
+ */
+class ABIFunctionCache
+{
+public:
+	/// The code of a generated function together with the functions it uses.
+	struct Function
+	{
+		std::string code;
+		std::map<std::string, std::shared_ptr<Function const>> dependencies;
+	};
+
+	/// @returns the function called @a _name for @a _evmVersion or nullptr if it is not cached.
+	std::shared_ptr<Function const> lookup(std::string const& _name, EVMVersion _evmVersion) const;
+	void store(std::string const& _name, EVMVersion _evmVersion, std::shared_ptr<Function const> const& _function);
+
+private:
+	mutable std::mutex m_mutex;
+	std::map<std::pair<std::string, EVMVersion>, std::shared_ptr<Function const>> m_functions;
+};
+
 ///
 /// Class to generate encoding and decoding functions. Also maintains a collection
 /// of "functions to be generated" in order to avoid generating the same function
@@ -50,7 +78,15 @@ using TypePointers = std::vector<TypePointer>;
 class ABIFunctions
 {
 public:
-	explicit ABIFunctions(EVMVersion _evmVersion = EVMVersion{}) : m_evmVersion(_evmVersion) {}
+	explicit ABIFunctions(
+		EVMVersion _evmVersion = EVMVersion{},
+		std::shared_ptr<ABIFunctionCache> _cache = nullptr
+	):
+		m_evmVersion(_evmVersion),
+		m_cache(std::move(_cache))
+	{}
+
+	std::shared_ptr<ABIFunctionCache> const& cache() const { return m_cache; }
 
 	/// @returns name of an assembly function to ABI-encode values of @a _givenTypes
 	/// into memory, converting the types to @a _targetTypes on the fly.
@@ -221,16 +257,23 @@ private:
 
 	/// Helper function that uses @a _creator to create a function and add it to
 	/// @a m_requestedFunctions if it has not been created yet and returns @a _name in both
-	/// cases.
+	/// cases. Functions found in @a m_cache are not created again.
 	std::string createFunction(std::string const& _name, std::function<std::string()> const& _creator);
+	/// Adds a cached function and the functions it uses to @a m_requestedFunctions.
+	void addCachedFunction(std::string const& _name, std::shared_ptr<ABIFunctionCache::Function const> const& _function);
 
 	/// @returns the size of the static part of the encoding of the given types.
 	static size_t headSize(TypePointers const& _targetTypes);
 
 	/// Map from function name to code for a multi-use function.
 	std::map<std::string, std::string> m_requestedFunctions;
+	/// Cache entries of the requested functions, used to record the dependencies of new entries.
+	std::map<std::string, std::shared_ptr<ABIFunctionCache::Function const>> m_cachedFunctions;
+	/// For each function currently being created, the names of the functions it uses.
+	std::vector<std::set<std::string>> m_dependencyStack;
 
 	EVMVersion m_evmVersion;
+	std::shared_ptr<ABIFunctionCache> m_cache;
 };
 
 }
@@ -397,7 +397,11 @@ void ArrayUtils::copyArrayToMemory(ArrayType const& _sourceType, bool _padToWord
 			m_context << u256(1);
 			m_context << Instruction::DUP4 << u256(32) << Instruction::SUB;
 			// stack: ...<v> 1 <32 - remainder>
-			m_context << u256(0x100) << Instruction::EXP << Instruction::SUB;
+			if (m_context.evmVersion().hasBitwiseShifting())
+				m_context << u256(8) << Instruction::MUL << Instruction::DUP2 << Instruction::SWAP1 << Instruction::SHL;
+			else
+				m_context << u256(0x100) << Instruction::EXP;
+			m_context << Instruction::SUB;
 			m_context << Instruction::NOT << Instruction::AND;
 			// stack: target+size remainder target+size-remainder <v & ...>
 			m_context << Instruction::DUP2 << Instruction::MSTORE;
@@ -434,9 +438,14 @@ void ArrayUtils::copyArrayToMemory(ArrayType const& _sourceType, bool _padToWord
 			m_context << Instruction::DUP1 << u256(31) << Instruction::LT;
 			eth::AssemblyItem longByteArray = m_context.appendConditionalJump();
 			// store the short byte array (discard lower-order byte)
-			m_context << u256(0x100) << Instruction::DUP1;
-			m_context << Instruction::DUP4 << Instruction::SLOAD;
-			m_context << Instruction::DIV << Instruction::MUL;
+			if (m_context.evmVersion().hasBitwiseShifting())
+				m_context << Instruction::DUP2 << Instruction::SLOAD << u256(0xff) << Instruction::NOT << Instruction::AND;
+			else
+			{
+				m_context << u256(0x100) << Instruction::DUP1;
+				m_context << Instruction::DUP4 << Instruction::SLOAD;
+				m_context << Instruction::DIV << Instruction::MUL;
+			}
 			m_context << Instruction::DUP4 << Instruction::MSTORE;
 			// stack here: memory_offset storage_offset length
 			// add 32 or length to memory offset
@@ -675,10 +684,17 @@ void ArrayUtils::resizeDynamicArray(ArrayType const& _typeIn) const
 				_context << shortToShort;
 				_context << Instruction::DUP3 << u256(8) << Instruction::MUL;
 				_context << u256(0x100) << Instruction::SUB;
-				_context << u256(2) << Instruction::EXP;
-				// Divide and multiply by that value, clearing bits.
-				_context << Instruction::DUP1 << Instruction::SWAP2;
-				_context << Instruction::DIV << Instruction::MUL;
+				if (_context.evmVersion().hasBitwiseShifting())
+					// Shift right and left by that many bits, clearing bits.
+					_context << Instruction::SWAP1 << Instruction::DUP2 << Instruction::SHR
+						<< Instruction::SWAP1 << Instruction::SHL;
+				else
+				{
+					_context << u256(2) << Instruction::EXP;
+					// Divide and multiply by that value, clearing bits.
+					_context << Instruction::DUP1 << Instruction::SWAP2;
+					_context << Instruction::DIV << Instruction::MUL;
+				}
 				// Insert 2*length.
 				_context << Instruction::DUP3 << Instruction::DUP1 << Instruction::ADD;
 				_context << Instruction::OR;
@@ -1017,7 +1033,7 @@ void ArrayUtils::retrieveLength(ArrayType const& _arrayType, unsigned _stackDept
 				m_context << u256(1) << Instruction::DUP2 << u256(1) << Instruction::AND;
 				m_context << Instruction::ISZERO << u256(0x100) << Instruction::MUL;
 				m_context << Instruction::SUB << Instruction::AND;
-				m_context << u256(2) << Instruction::SWAP1 << Instruction::DIV;
+				CompilerUtils(m_context).rightShiftNumberOnStack(1);
 			}
 			break;
 		}
@@ -1128,9 +1144,15 @@ void ArrayUtils::incrementByteOffset(unsigned _byteSize, unsigned _byteOffsetPos
 	if (_byteOffsetPosition > 1)
 		m_context << swapInstruction(_byteOffsetPosition - 1);
 	// compute, X := (byteOffset + byteSize - 1) / 32, should be 1 iff byteOffset + bytesize > 32
-	m_context
-		<< u256(32) << dupInstruction(1 + _byteOffsetPosition) << u256(_byteSize - 1)
-		<< Instruction::ADD << Instruction::DIV;
+	if (m_context.evmVersion().hasBitwiseShifting())
+	{
+		m_context << dupInstruction(_byteOffsetPosition) << u256(_byteSize - 1) << Instruction::ADD;
+		CompilerUtils(m_context).rightShiftNumberOnStack(5);
+	}
+	else
+		m_context
+			<< u256(32) << dupInstruction(1 + _byteOffsetPosition) << u256(_byteSize - 1)
+			<< Instruction::ADD << Instruction::DIV;
 	// increment storage offset if X == 1 (just add X to it)
 	// stack: X
 	m_context
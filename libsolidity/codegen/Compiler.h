@@ -36,20 +36,44 @@ namespace solidity {
 class Compiler
 {
 public:
-	explicit Compiler(EVMVersion _evmVersion = EVMVersion{}, bool _optimize = false, unsigned _runs = 200):
+	explicit Compiler(
+		EVMVersion _evmVersion = EVMVersion{},
+		bool _optimize = false,
+		unsigned _runs = 200,
+		bool _optimizeControlFlow = false,
+		std::shared_ptr<ABIFunctionCache> const& _abiFunctionCache = nullptr
+	):
 		m_optimize(_optimize),
 		m_optimizeRuns(_runs),
-		m_runtimeContext(_evmVersion),
-		m_context(_evmVersion, &m_runtimeContext)
+		m_optimizeControlFlow(_optimizeControlFlow),
+		m_runtimeContext(_evmVersion, nullptr, _abiFunctionCache),
+		m_context(_evmVersion, &m_runtimeContext, _abiFunctionCache)
 	{ }
 
-	/// Compiles a contract.
+	/// Compiles a contract, i.e. generates its code and runs the optimiser.
 	/// @arg _metadata contains the to be injected metadata CBOR
 	void compileContract(
 		ContractDefinition const& _contract,
 		std::map<ContractDefinition const*, eth::Assembly const*> const& _contracts,
 		bytes const& _metadata
+	)
+	{
+		generateCode(_contract, _contracts, _metadata);
+		optimise();
+	}
+	/// Generates the unoptimised code for a contract. This is the only step that accesses the AST.
+	/// @arg _metadata contains the to be injected metadata CBOR
+	void generateCode(
+		ContractDefinition const& _contract,
+		std::map<ContractDefinition const*, eth::Assembly const*> const& _contracts,
+		bytes const& _metadata
 	);
+	/// Runs the optimiser on the generated code. Only operates on the assembly of this compiler.
+	/// Sub-assemblies are optimised using up to @a _parallelism threads.
+	void optimise(unsigned _parallelism = 1)
+	{
+		m_context.optimise(m_optimize, m_optimizeRuns, _parallelism, m_optimizeControlFlow);
+	}
 	/// @returns Entire assembly.
 	eth::Assembly const& assembly() const { return m_context.assembly(); }
 	/// @returns The entire assembled object (with constructor).
@@ -78,6 +102,7 @@ public:
 private:
 	bool const m_optimize;
 	unsigned const m_optimizeRuns;
+	bool const m_optimizeControlFlow;
 	CompilerContext m_runtimeContext;
 	size_t m_runtimeSub = size_t(-1); ///< Identifier of the runtime sub-assembly, if present.
 	CompilerContext m_context;
@@ -33,10 +33,13 @@
 #include <libsolidity/inlineasm/AsmAnalysis.h>
 #include <libsolidity/inlineasm/AsmAnalysisInfo.h>
 
+#include <libdevcore/LRUCache.h>
+
 #include <boost/algorithm/string/replace.hpp>
 
-#include <utility>
 #include <numeric>
+#include <tuple>
+#include <utility>
 
 // Change to "define" to output all intermediate code
 #undef SOL_OUTPUT_ASM
@@ -52,6 +55,78 @@ namespace dev
 namespace solidity
 {
 
+namespace
+{
+
+/// An inline assembly snippet of the code generator after parsing and analysis.
+/// Neither is modified by the code transform, so it can be assembled by several threads at once.
+struct ParsedInlineAssembly
+{
+	shared_ptr<assembly::Block> block;
+	shared_ptr<assembly::AsmAnalysisInfo> analysisInfo;
+};
+
+/// Parsing and analysis depend on the source of the snippet, the local variables it can
+/// access and the EVM version.
+using InlineAssemblyKey = tuple<string, vector<string>, EVMVersion>;
+
+/// Process-wide cache of the inline assembly snippets of the code generator. The same
+/// snippets are appended many times per contract, so they are only parsed and analysed once.
+LRUCache<InlineAssemblyKey, shared_ptr<ParsedInlineAssembly const>>& inlineAssemblyCache()
+{
+	static LRUCache<InlineAssemblyKey, shared_ptr<ParsedInlineAssembly const>> cache(0x1000);
+	return cache;
+}
+
+/// Parses and analyses an inline assembly snippet of the code generator, which must not fail.
+shared_ptr<ParsedInlineAssembly const> parseInlineAssembly(
+	string const& _assembly,
+	julia::ExternalIdentifierAccess::Resolver const& _resolver,
+	EVMVersion _evmVersion
+)
+{
+	ErrorList errors;
+	ErrorReporter errorReporter(errors);
+	auto scanner = make_shared<Scanner>(CharStream(_assembly), "--CODEGEN--");
+	auto parserResult = assembly::Parser(errorReporter, assembly::AsmFlavour::Strict).parse(scanner, false);
+#ifdef SOL_OUTPUT_ASM
+	cout << assembly::AsmPrinter()(*parserResult) << endl;
+#endif
+	auto analysisInfo = make_shared<assembly::AsmAnalysisInfo>();
+	bool analyzerResult = false;
+	if (parserResult)
+		analyzerResult = assembly::AsmAnalyzer(
+			*analysisInfo,
+			errorReporter,
+			_evmVersion,
+			boost::none,
+			assembly::AsmFlavour::Strict,
+			_resolver
+		).analyze(*parserResult);
+	if (!parserResult || !errorReporter.errors().empty() || !analyzerResult)
+	{
+		string message =
+			"Error parsing/analyzing inline assembly block:\n"
+			"------------------ Input: -----------------\n" +
+			_assembly + "\n"
+			"------------------ Errors: ----------------\n";
+		for (auto const& error: errorReporter.errors())
+			message += SourceReferenceFormatter::formatExceptionInformation(
+				*error,
+				(error->type() == Error::Type::Warning) ? "Warning" : "Error",
+				[&](string const&) -> Scanner const& { return *scanner; }
+			);
+		message += "-------------------------------------------\n";
+
+		solAssert(false, message);
+	}
+
+	solAssert(errorReporter.errors().empty(), "Failed to analyze inline assembly block.");
+	return make_shared<ParsedInlineAssembly const>(ParsedInlineAssembly{parserResult, analysisInfo});
+}
+
+}
+
 void CompilerContext::addStateVariable(
 	VariableDeclaration const& _declaration,
 	u256 const& _storageOffset,
@@ -355,44 +430,14 @@ void CompilerContext::appendInlineAssembly(
 		}
 	};
 
-	ErrorList errors;
-	ErrorReporter errorReporter(errors);
-	auto scanner = make_shared<Scanner>(CharStream(_assembly), "--CODEGEN--");
-	auto parserResult = assembly::Parser(errorReporter, assembly::AsmFlavour::Strict).parse(scanner, false);
-#ifdef SOL_OUTPUT_ASM
-	cout << assembly::AsmPrinter()(*parserResult) << endl;
-#endif
-	assembly::AsmAnalysisInfo analysisInfo;
-	bool analyzerResult = false;
-	if (parserResult)
-		analyzerResult = assembly::AsmAnalyzer(
-			analysisInfo,
-			errorReporter,
-			m_evmVersion,
-			boost::none,
-			assembly::AsmFlavour::Strict,
-			identifierAccess.resolve
-		).analyze(*parserResult);
-	if (!parserResult || !errorReporter.errors().empty() || !analyzerResult)
+	InlineAssemblyKey key(_assembly, _localVariables, m_evmVersion);
+	shared_ptr<ParsedInlineAssembly const> parsed = inlineAssemblyCache().lookup(key).value_or(nullptr);
+	if (!parsed)
 	{
-		string message =
-			"Error parsing/analyzing inline assembly block:\n"
-			"------------------ Input: -----------------\n" +
-			_assembly + "\n"
-			"------------------ Errors: ----------------\n";
-		for (auto const& error: errorReporter.errors())
-			message += SourceReferenceFormatter::formatExceptionInformation(
-				*error,
-				(error->type() == Error::Type::Warning) ? "Warning" : "Error",
-				[&](string const&) -> Scanner const& { return *scanner; }
-			);
-		message += "-------------------------------------------\n";
-
-		solAssert(false, message);
+		parsed = parseInlineAssembly(_assembly, identifierAccess.resolve, m_evmVersion);
+		inlineAssemblyCache().store(key, parsed);
 	}
-
-	solAssert(errorReporter.errors().empty(), "Failed to analyze inline assembly block.");
-	assembly::CodeGenerator::assemble(*parserResult, analysisInfo, *m_asm, identifierAccess, _system);
+	assembly::CodeGenerator::assemble(*parsed->block, *parsed->analysisInfo, *m_asm, identifierAccess, _system);
 
 	// Reset the source location to the one of the node (instead of the CODEGEN source location)
 	updateSourceLocation();
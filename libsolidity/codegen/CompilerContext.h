@@ -52,11 +52,15 @@ namespace solidity {
 class CompilerContext
 {
 public:
-	explicit CompilerContext(EVMVersion _evmVersion = EVMVersion{}, CompilerContext* _runtimeContext = nullptr):
+	explicit CompilerContext(
+		EVMVersion _evmVersion = EVMVersion{},
+		CompilerContext* _runtimeContext = nullptr,
+		std::shared_ptr<ABIFunctionCache> _abiFunctionCache = nullptr
+	):
 		m_asm(std::make_shared<eth::Assembly>()),
 		m_evmVersion(_evmVersion),
 		m_runtimeContext(_runtimeContext),
-		m_abiFunctions(m_evmVersion)
+		m_abiFunctions(m_evmVersion, std::move(_abiFunctionCache))
 	{
 		if (m_runtimeContext)
 			m_runtimeSub = size_t(m_asm->newSub(m_runtimeContext->m_asm).data());
@@ -216,8 +220,12 @@ public:
 	/// Appends arbitrary data to the end of the bytecode.
 	void appendAuxiliaryData(bytes const& _data) { m_asm->appendAuxiliaryDataToEnd(_data); }
 
-	/// Run optimisation step.
-	void optimise(bool _fullOptimsation, unsigned _runs = 200) { m_asm->optimise(_fullOptimsation, m_evmVersion, true, _runs); }
+	/// Run optimisation step, using up to @a _parallelism threads for the sub-assemblies.
+	/// @a _controlFlow enables the optimisation across basic blocks.
+	void optimise(bool _fullOptimsation, unsigned _runs = 200, unsigned _parallelism = 1, bool _controlFlow = false)
+	{
+		m_asm->optimise(_fullOptimsation, m_evmVersion, true, _runs, _parallelism, _controlFlow);
+	}
 
 	/// @returns the runtime context if in creation mode and runtime context is set, nullptr otherwise.
 	CompilerContext* runtimeContext() { return m_runtimeContext; }
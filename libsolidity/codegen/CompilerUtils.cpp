@@ -545,7 +545,7 @@ void CompilerUtils::memoryCopy()
 {
 	// Stack here: size target source
 
-	m_context.appendInlineAssembly(R"(
+	Whiskers templ(R"(
 		{
 			// copy 32 bytes at once
 			for
@@ -558,15 +558,18 @@ void CompilerUtils::memoryCopy()
 				}
 				{ mstore(dst, mload(src)) }
 
-			// copy the remainder (0 < len < 32)
-			let mask := sub(exp(256, sub(32, len)), 1)
+			// copy the remainder (len in 1..31)
+			let mask := sub(<power>, 1)
 			let srcpart := and(mload(src), not(mask))
 			let dstpart := and(mload(dst), mask)
 			mstore(dst, or(srcpart, dstpart))
 		}
-	)",
-		{ "len", "dst", "src" }
-	);
+	)");
+	if (m_context.evmVersion().hasBitwiseShifting())
+		templ("power", "shl(mul(8, sub(32, len)), 1)");
+	else
+		templ("power", "exp(256, sub(32, len))");
+	m_context.appendInlineAssembly(templ.render(), { "len", "dst", "src" });
 	m_context << Instruction::POP << Instruction::POP << Instruction::POP;
 }
 
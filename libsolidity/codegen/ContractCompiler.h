@@ -38,12 +38,22 @@ namespace solidity {
 class ContractCompiler: private ASTConstVisitor
 {
 public:
-	explicit ContractCompiler(ContractCompiler* _runtimeCompiler, CompilerContext& _context, bool _optimise):
+	explicit ContractCompiler(
+		ContractCompiler* _runtimeCompiler,
+		CompilerContext& _context,
+		bool _optimise,
+		size_t _optimiseRuns = 200
+	):
 		m_optimise(_optimise),
+		m_optimiseRuns(_optimiseRuns),
 		m_runtimeCompiler(_runtimeCompiler),
 		m_context(_context)
 	{
-		m_context = CompilerContext(_context.evmVersion(), _runtimeCompiler ? &_runtimeCompiler->m_context : nullptr);
+		m_context = CompilerContext(
+			_context.evmVersion(),
+			_runtimeCompiler ? &_runtimeCompiler->m_context : nullptr,
+			_context.abiFunctions().cache()
+		);
 	}
 
 	void compileContract(
@@ -82,6 +92,15 @@ private:
 	/// whose data will be modified in memory at deploy time.
 	void appendDelegatecallCheck();
 	void appendFunctionSelector(ContractDefinition const& _contract);
+	/// Appends code that jumps to the entry point of the function whose selector is on the stack
+	/// or to @a _notFoundTag. @a _ids are sorted and split into a balanced search tree if the
+	/// optimiser is enabled and this saves more gas over the expected number of runs than the
+	/// larger code costs at deployment.
+	void appendInternalSelector(
+		std::map<FixedHash<4>, eth::AssemblyItem const> const& _entryPoints,
+		std::vector<FixedHash<4>> const& _ids,
+		eth::AssemblyItem const& _notFoundTag
+	);
 	void appendCallValueCheck();
 	void appendReturnValuePacker(TypePointers const& _typeParameters, bool _isLibrary);
 
@@ -122,6 +141,8 @@ private:
 	void storeStackHeight(ASTNode const* _node);
 
 	bool const m_optimise;
+	/// Expected number of runs of the contract, used to trade code size against execution cost.
+	size_t const m_optimiseRuns;
 	/// Pointer to the runtime compiler in case this is a creation compiler.
 	ContractCompiler* m_runtimeCompiler = nullptr;
 	CompilerContext& m_context;
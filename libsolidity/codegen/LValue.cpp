@@ -178,9 +178,11 @@ void StorageItem::retrieveValue(SourceLocation const&, bool _remove) const
 	else
 	{
 		bool cleaned = false;
-		m_context
-			<< Instruction::SWAP1 << Instruction::SLOAD << Instruction::SWAP1
-			<< u256(0x100) << Instruction::EXP << Instruction::SWAP1 << Instruction::DIV;
+		m_context << Instruction::SWAP1 << Instruction::SLOAD << Instruction::SWAP1;
+		if (m_context.evmVersion().hasBitwiseShifting())
+			m_context << u256(8) << Instruction::MUL << Instruction::SHR;
+		else
+			m_context << u256(0x100) << Instruction::EXP << Instruction::SWAP1 << Instruction::DIV;
 		if (m_dataType->category() == Type::Category::FixedPoint)
 			// implementation should be very similar to the integer case.
 			solUnimplemented("Not yet implemented - FixedPointType.");
@@ -240,15 +242,22 @@ void StorageItem::storeValue(Type const& _sourceType, SourceLocation const& _loc
 		else
 		{
 			// OR the value into the other values in the storage slot
-			m_context << u256(0x100) << Instruction::EXP;
+			bool const shifting = m_context.evmVersion().hasBitwiseShifting();
+			if (shifting)
+				m_context << u256(8) << Instruction::MUL;
+			else
+				m_context << u256(0x100) << Instruction::EXP;
 			// stack: value storage_ref multiplier
+			// (the multiplier is the number of bits to shift by if shifting is available)
 			// fetch old value
 			m_context << Instruction::DUP2 << Instruction::SLOAD;
 			// stack: value storege_ref multiplier old_full_value
 			// clear bytes in old value
-			m_context
-				<< Instruction::DUP2 << ((u256(1) << (8 * m_dataType->storageBytes())) - 1)
-				<< Instruction::MUL;
+			u256 const mask = (u256(1) << (8 * m_dataType->storageBytes())) - 1;
+			if (shifting)
+				m_context << mask << Instruction::DUP3 << Instruction::SHL;
+			else
+				m_context << Instruction::DUP2 << mask << Instruction::MUL;
 			m_context << Instruction::NOT << Instruction::AND << Instruction::SWAP1;
 			// stack: value storage_ref cleared_value multiplier
 			utils.copyToStackTop(3 + m_dataType->sizeOnStack(), m_dataType->sizeOnStack());
@@ -275,7 +284,11 @@ void StorageItem::storeValue(Type const& _sourceType, SourceLocation const& _loc
 				// remove the higher order bits
 				utils.convertType(_sourceType, *m_dataType, true, true);
 			}
-			m_context  << Instruction::MUL << Instruction::OR;
+			if (shifting)
+				m_context << Instruction::SWAP1 << Instruction::SHL;
+			else
+				m_context << Instruction::MUL;
+			m_context << Instruction::OR;
 			// stack: value storage_ref updated_value
 			m_context << Instruction::SWAP1 << Instruction::SSTORE;
 			if (_move)
@@ -401,15 +414,22 @@ void StorageItem::setToZero(SourceLocation const&, bool _removeReference) const
 		}
 		else
 		{
-			m_context << u256(0x100) << Instruction::EXP;
+			bool const shifting = m_context.evmVersion().hasBitwiseShifting();
+			if (shifting)
+				m_context << u256(8) << Instruction::MUL;
+			else
+				m_context << u256(0x100) << Instruction::EXP;
 			// stack: storage_ref multiplier
+			// (the multiplier is the number of bits to shift by if shifting is available)
 			// fetch old value
 			m_context << Instruction::DUP2 << Instruction::SLOAD;
 			// stack: storege_ref multiplier old_full_value
 			// clear bytes in old value
-			m_context
-				<< Instruction::SWAP1 << ((u256(1) << (8 * m_dataType->storageBytes())) - 1)
-				<< Instruction::MUL;
+			m_context << Instruction::SWAP1 << ((u256(1) << (8 * m_dataType->storageBytes())) - 1);
+			if (shifting)
+				m_context << Instruction::SWAP1 << Instruction::SHL;
+			else
+				m_context << Instruction::MUL;
 			m_context << Instruction::NOT << Instruction::AND;
 			// stack: storage_ref cleared_value
 			m_context << Instruction::SWAP1 << Instruction::SSTORE;
@@ -434,23 +454,40 @@ void StorageByteArrayElement::retrieveValue(SourceLocation const&, bool _remove)
 	else
 		m_context << Instruction::DUP2 << Instruction::SLOAD
 			<< Instruction::DUP2 << Instruction::BYTE;
-	m_context << (u256(1) << (256 - 8)) << Instruction::MUL;
+	CompilerUtils(m_context).leftShiftNumberOnStack(256 - 8);
 }
 
 void StorageByteArrayElement::storeValue(Type const&, SourceLocation const&, bool _move) const
 {
 	// stack: value ref byte_number
-	m_context << u256(31) << Instruction::SUB << u256(0x100) << Instruction::EXP;
-	// stack: value ref (1<<(8*(31-byte_number)))
-	m_context << Instruction::DUP2 << Instruction::SLOAD;
-	// stack: value ref (1<<(8*(31-byte_number))) old_full_value
-	// clear byte in old value
-	m_context << Instruction::DUP2 << u256(0xff) << Instruction::MUL
-		<< Instruction::NOT << Instruction::AND;
-	// stack: value ref (1<<(32-byte_number)) old_full_value_with_cleared_byte
-	m_context << Instruction::SWAP1;
-	m_context << (u256(1) << (256 - 8)) << Instruction::DUP5 << Instruction::DIV
-		<< Instruction::MUL << Instruction::OR;
+	if (m_context.evmVersion().hasBitwiseShifting())
+	{
+		m_context << u256(31) << Instruction::SUB << u256(8) << Instruction::MUL;
+		// stack: value ref (8*(31-byte_number))
+		m_context << Instruction::DUP2 << Instruction::SLOAD;
+		// stack: value ref (8*(31-byte_number)) old_full_value
+		// clear byte in old value
+		m_context << u256(0xff) << Instruction::DUP3 << Instruction::SHL
+			<< Instruction::NOT << Instruction::AND;
+		// stack: value ref (8*(31-byte_number)) old_full_value_with_cleared_byte
+		m_context << Instruction::SWAP1 << Instruction::DUP4;
+		CompilerUtils(m_context).rightShiftNumberOnStack(256 - 8);
+		m_context << Instruction::SWAP1 << Instruction::SHL << Instruction::OR;
+	}
+	else
+	{
+		m_context << u256(31) << Instruction::SUB << u256(0x100) << Instruction::EXP;
+		// stack: value ref (1<<(8*(31-byte_number)))
+		m_context << Instruction::DUP2 << Instruction::SLOAD;
+		// stack: value ref (1<<(8*(31-byte_number))) old_full_value
+		// clear byte in old value
+		m_context << Instruction::DUP2 << u256(0xff) << Instruction::MUL
+			<< Instruction::NOT << Instruction::AND;
+		// stack: value ref (1<<(32-byte_number)) old_full_value_with_cleared_byte
+		m_context << Instruction::SWAP1;
+		m_context << (u256(1) << (256 - 8)) << Instruction::DUP5 << Instruction::DIV
+			<< Instruction::MUL << Instruction::OR;
+	}
 	// stack: value ref new_full_value
 	m_context << Instruction::SWAP1 << Instruction::SSTORE;
 	if (_move)
@@ -462,12 +499,21 @@ void StorageByteArrayElement::setToZero(SourceLocation const&, bool _removeRefer
 	// stack: ref byte_number
 	if (!_removeReference)
 		m_context << Instruction::DUP2 << Instruction::DUP2;
-	m_context << u256(31) << Instruction::SUB << u256(0x100) << Instruction::EXP;
-	// stack: ref (1<<(8*(31-byte_number)))
+	bool const shifting = m_context.evmVersion().hasBitwiseShifting();
+	m_context << u256(31) << Instruction::SUB;
+	if (shifting)
+		m_context << u256(8) << Instruction::MUL;
+	else
+		m_context << u256(0x100) << Instruction::EXP;
+	// stack: ref (1<<(8*(31-byte_number))), or (8*(31-byte_number)) if shifting is available
 	m_context << Instruction::DUP2 << Instruction::SLOAD;
 	// stack: ref (1<<(8*(31-byte_number))) old_full_value
 	// clear byte in old value
-	m_context << Instruction::SWAP1 << u256(0xff) << Instruction::MUL;
+	m_context << Instruction::SWAP1 << u256(0xff);
+	if (shifting)
+		m_context << Instruction::SWAP1 << Instruction::SHL;
+	else
+		m_context << Instruction::MUL;
 	m_context << Instruction::NOT << Instruction::AND;
 	// stack: ref old_full_value_with_cleared_byte
 	m_context << Instruction::SWAP1 << Instruction::SSTORE;
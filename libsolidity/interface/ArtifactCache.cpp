@@ -0,0 +1,66 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Content-addressed cache for the compilation artifacts of contracts.
+ */
+
+#include <libsolidity/interface/ArtifactCache.h>
+
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/JSON.h>
+
+#include <boost/filesystem.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+Json::Value ArtifactCache::load(h256 const& _key)
+{
+	if (m_directory.empty())
+		return m_entries.lookup(_key).value_or(Json::Value());
+
+	Json::Value entry;
+	string content = readFileAsString(path(_key));
+	if (content.empty() || !jsonParseStrict(content, entry) || !entry.isObject())
+		return Json::Value();
+	return entry;
+}
+
+void ArtifactCache::store(h256 const& _key, Json::Value const& _entry)
+{
+	if (m_directory.empty())
+	{
+		m_entries.store(_key, _entry);
+		return;
+	}
+
+	try
+	{
+		boost::filesystem::create_directories(m_directory);
+		writeFile(path(_key), jsonCompactPrint(_entry), true);
+	}
+	catch (...)
+	{
+		// The cache is only an optimisation, so failing to persist an entry is not an error.
+	}
+}
+
+string ArtifactCache::path(h256 const& _key) const
+{
+	return (boost::filesystem::path(m_directory) / (_key.hex() + ".json")).string();
+}
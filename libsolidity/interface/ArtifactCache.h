@@ -0,0 +1,71 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Content-addressed cache for the compilation artifacts of contracts.
+ */
+
+#pragma once
+
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/LRUCache.h>
+
+#include <json/json.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <string>
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Stores JSON artifacts under a key that is a hash of everything the artifacts depend on.
+ * If a directory is given, entries are stored as one file per entry in that directory, so that
+ * they can be reused by other processes, and are not kept in memory. Otherwise, only the most
+ * recently used entries are kept in memory. Files are written atomically, so several processes
+ * can share a directory. Unreadable files are treated as missing entries.
+ * All functions can be called concurrently.
+ */
+class ArtifactCache: private boost::noncopyable
+{
+public:
+	/// @param _directory directory to persist the entries in, created on the first store.
+	/// Entries are only kept in memory if it is empty.
+	/// @param _maxEntriesInMemory number of entries kept in memory if no directory is given.
+	explicit ArtifactCache(std::string const& _directory = std::string(), size_t _maxEntriesInMemory = 256):
+		m_directory(_directory),
+		m_entries(_maxEntriesInMemory)
+	{}
+
+	/// @returns the entry stored under @a _key or a null value if there is none.
+	Json::Value load(h256 const& _key);
+	/// Stores @a _entry under @a _key, replacing any previous entry.
+	void store(h256 const& _key, Json::Value const& _entry);
+
+	std::string const& directory() const { return m_directory; }
+
+private:
+	std::string path(h256 const& _key) const;
+
+	std::string const m_directory;
+	LRUCache<h256, Json::Value> m_entries;
+};
+
+}
+}
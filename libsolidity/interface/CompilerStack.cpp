@@ -27,6 +27,7 @@
 #include <libsolidity/interface/Version.h>
 #include <libsolidity/analysis/SemVerHandler.h>
 #include <libsolidity/ast/AST.h>
+#include <libsolidity/ast/ASTVisitor.h>
 #include <libsolidity/parsing/Scanner.h>
 #include <libsolidity/parsing/Parser.h>
 #include <libsolidity/analysis/ControlFlowAnalyzer.h>
@@ -40,8 +41,10 @@
 #include <libsolidity/analysis/SyntaxChecker.h>
 #include <libsolidity/analysis/ViewPureChecker.h>
 #include <libsolidity/codegen/Compiler.h>
+#include <libsolidity/codegen/CompilerUtils.h>
 #include <libsolidity/formal/SMTChecker.h>
 #include <libsolidity/interface/ABI.h>
+#include <libsolidity/interface/ArtifactCache.h>
 #include <libsolidity/interface/Natspec.h>
 #include <libsolidity/interface/GasEstimator.h>
 
@@ -49,11 +52,19 @@
 
 #include <libdevcore/SwarmHash.h>
 #include <libdevcore/JSON.h>
+#include <libdevcore/TimingReport.h>
 
 #include <json/json.h>
 
 #include <boost/algorithm/string.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
 using namespace std;
 using namespace dev;
 using namespace dev::solidity;
@@ -108,10 +119,13 @@ void CompilerStack::reset(bool _keepSources)
 	m_evmVersion = EVMVersion();
 	m_optimize = false;
 	m_optimizeRuns = 200;
+	m_optimizeControlFlow = false;
+	m_parallelism = 1;
 	m_globalContext.reset();
 	m_scopes.clear();
 	m_sourceOrder.clear();
 	m_contracts.clear();
+	m_abiFunctionCache.reset();
 	m_errorReporter.clear();
 }
 
@@ -120,17 +134,40 @@ bool CompilerStack::addSource(string const& _name, string const& _content, bool
 	bool existed = m_sources.count(_name) != 0;
 	reset(true);
 	m_sources[_name].scanner = make_shared<Scanner>(CharStream(_content), _name);
+	m_sources[_name].contentHash = dev::keccak256(_content);
 	m_sources[_name].isLibrary = _isLibrary;
 	m_stackState = SourcesSet;
 	return existed;
 }
 
+namespace
+{
+
+/// Removes the results of a previous analysis from all nodes of a syntax tree.
+class AnalysisClearer: private ASTVisitor
+{
+public:
+	void clear(ASTNode& _root) { _root.accept(*this); }
+
+private:
+	bool visitNode(ASTNode& _node) override
+	{
+		_node.clearAnalysis();
+		if (auto scopable = dynamic_cast<Scopable*>(&_node))
+			scopable->setScope(nullptr);
+		return true;
+	}
+};
+
+}
+
 bool CompilerStack::parse()
 {
 	//reset
 	if (m_stackState != SourcesSet)
 		return false;
 	m_errorReporter.clear();
+	ASTNodeIDScope idScope(m_nodeIDCounter);
 	ASTNode::resetID();
 
 	if (SemVerVersion{string(VersionString)}.isPrerelease())
@@ -142,9 +179,30 @@ bool CompilerStack::parse()
 	for (size_t i = 0; i < sourcesToParse.size(); ++i)
 	{
 		string const& path = sourcesToParse[i];
+		TimingScope timing("parsing", path);
 		Source& source = m_sources[path];
-		source.scanner->reset();
-		source.ast = Parser(m_errorReporter).parse(source.scanner);
+		auto parsedSource = m_parsedSources.find(path);
+		source.firstNodeID = m_nodeIDCounter + 1;
+		// Syntax trees are only reused if a new parse would assign the same node IDs, because
+		// the IDs end up in type identifiers and thus in the names of generated routines.
+		if (
+			m_incrementalParsing &&
+			parsedSource != m_parsedSources.end() &&
+			parsedSource->second.contentHash == source.contentHash &&
+			parsedSource->second.firstNodeID == source.firstNodeID
+		)
+		{
+			source.ast = parsedSource->second.ast;
+			source.nodeIDsEnd = parsedSource->second.nodeIDsEnd;
+			m_nodeIDCounter = source.nodeIDsEnd;
+			AnalysisClearer().clear(*source.ast);
+		}
+		else
+		{
+			source.scanner->reset();
+			source.ast = Parser(m_errorReporter).parse(source.scanner);
+			source.nodeIDsEnd = m_nodeIDCounter;
+		}
 		if (!source.ast)
 			solAssert(!Error::containsOnlyWarnings(m_errorReporter.errors()), "Parser returned null but did not report error.");
 		else
@@ -155,12 +213,15 @@ bool CompilerStack::parse()
 				string const& newPath = newSource.first;
 				string const& newContents = newSource.second;
 				m_sources[newPath].scanner = make_shared<Scanner>(CharStream(newContents), newPath);
+				m_sources[newPath].contentHash = dev::keccak256(newContents);
 				sourcesToParse.push_back(newPath);
 			}
 		}
 	}
 	if (Error::containsOnlyWarnings(m_errorReporter.errors()))
 	{
+		if (m_incrementalParsing)
+			m_parsedSources = m_sources;
 		m_stackState = ParsingSuccessful;
 		return true;
 	}
@@ -172,6 +233,8 @@ bool CompilerStack::analyze()
 {
 	if (m_stackState != ParsingSuccessful)
 		return false;
+	// The declarations of global variables are created here and continue the sequence of IDs.
+	ASTNodeIDScope idScope(m_nodeIDCounter);
 	resolveImports();
 
 	bool noErrors = true;
@@ -179,19 +242,28 @@ bool CompilerStack::analyze()
 	try {
 		SyntaxChecker syntaxChecker(m_errorReporter);
 		for (Source const* source: m_sourceOrder)
+		{
+			TimingScope timing("syntaxChecking", source->ast->annotation().path);
 			if (!syntaxChecker.checkSyntax(*source->ast))
 				noErrors = false;
+		}
 
 		DocStringAnalyser docStringAnalyser(m_errorReporter);
 		for (Source const* source: m_sourceOrder)
+		{
+			TimingScope timing("docStringAnalysis", source->ast->annotation().path);
 			if (!docStringAnalyser.analyseDocStrings(*source->ast))
 				noErrors = false;
+		}
 
 		m_globalContext = make_shared<GlobalContext>();
 		NameAndTypeResolver resolver(m_globalContext->declarations(), m_scopes, m_errorReporter);
 		for (Source const* source: m_sourceOrder)
+		{
+			TimingScope timing("declarationRegistration", source->ast->annotation().path);
 			if (!resolver.registerDeclarations(*source->ast))
 				return false;
+		}
 
 		map<string, SourceUnit const*> sourceUnitsByName;
 		for (auto& source: m_sources)
@@ -206,6 +278,7 @@ bool CompilerStack::analyze()
 			for (ASTPointer<ASTNode> const& node: source->ast->nodes())
 				if (ContractDefinition* contract = dynamic_cast<ContractDefinition*>(node.get()))
 				{
+					TimingScope timing("nameAndTypeResolution", contract->fullyQualifiedName());
 					m_globalContext->setCurrentContract(*contract);
 					if (!resolver.updateDeclaration(*m_globalContext->currentThis())) return false;
 					if (!resolver.updateDeclaration(*m_globalContext->currentSuper())) return false;
@@ -228,16 +301,22 @@ bool CompilerStack::analyze()
 		for (Source const* source: m_sourceOrder)
 			for (ASTPointer<ASTNode> const& node: source->ast->nodes())
 				if (ContractDefinition* contract = dynamic_cast<ContractDefinition*>(node.get()))
+				{
+					TimingScope timing("typeChecking", contract->fullyQualifiedName());
 					if (!typeChecker.checkTypeRequirements(*contract))
 						noErrors = false;
+				}
 
 		if (noErrors)
 		{
 			// Checks that can only be done when all types of all AST nodes are known.
 			PostTypeChecker postTypeChecker(m_errorReporter);
 			for (Source const* source: m_sourceOrder)
+			{
+				TimingScope timing("postTypeChecking", source->ast->annotation().path);
 				if (!postTypeChecker.check(*source->ast))
 					noErrors = false;
+			}
 		}
 
 		if (noErrors)
@@ -246,15 +325,21 @@ bool CompilerStack::analyze()
 			// variable is used before it is assigned to.
 			CFG cfg(m_errorReporter);
 			for (Source const* source: m_sourceOrder)
+			{
+				TimingScope timing("controlFlowGraph", source->ast->annotation().path);
 				if (!cfg.constructFlow(*source->ast))
 					noErrors = false;
+			}
 
 			if (noErrors)
 			{
 				ControlFlowAnalyzer controlFlowAnalyzer(cfg, m_errorReporter);
 				for (Source const* source: m_sourceOrder)
+				{
+					TimingScope timing("controlFlowAnalysis", source->ast->annotation().path);
 					if (!controlFlowAnalyzer.analyze(*source->ast))
 						noErrors = false;
+				}
 			}
 		}
 
@@ -263,8 +348,11 @@ bool CompilerStack::analyze()
 			// Checks for common mistakes. Only generates warnings.
 			StaticAnalyzer staticAnalyzer(m_errorReporter);
 			for (Source const* source: m_sourceOrder)
+			{
+				TimingScope timing("staticAnalysis", source->ast->annotation().path);
 				if (!staticAnalyzer.analyze(*source->ast))
 					noErrors = false;
+			}
 		}
 
 		if (noErrors)
@@ -274,6 +362,7 @@ bool CompilerStack::analyze()
 			for (Source const* source: m_sourceOrder)
 				ast.push_back(source->ast);
 
+			TimingScope timing("viewPureChecking");
 			if (!ViewPureChecker(ast, m_errorReporter).check())
 				noErrors = false;
 		}
@@ -282,7 +371,10 @@ bool CompilerStack::analyze()
 		{
 			SMTChecker smtChecker(m_errorReporter, m_smtQuery);
 			for (Source const* source: m_sourceOrder)
+			{
+				TimingScope timing("smtChecking", source->ast->annotation().path);
 				smtChecker.analyze(*source->ast);
+			}
 		}
 	}
 	catch(FatalError const&)
@@ -321,12 +413,46 @@ bool CompilerStack::compile()
 			return false;
 
 	// Only compile contracts individually which have been requested.
-	map<ContractDefinition const*, eth::Assembly const*> compiledContracts;
+	vector<ContractDefinition const*> requestedContracts;
 	for (Source const* source: m_sourceOrder)
 		for (ASTPointer<ASTNode> const& node: source->ast->nodes())
 			if (auto contract = dynamic_cast<ContractDefinition const*>(node.get()))
 				if (isRequestedContract(*contract))
-					compileContract(*contract, compiledContracts);
+					if (!loadArtifacts(m_contracts.at(contract->fullyQualifiedName())))
+						requestedContracts.push_back(contract);
+
+	m_abiFunctionCache = make_shared<ABIFunctionCache>();
+
+	if (m_parallelism <= 1)
+	{
+		map<ContractDefinition const*, eth::Assembly const*> compiledContracts;
+		for (auto const* contract: requestedContracts)
+			compileContract(*contract, compiledContracts);
+	}
+	else
+	{
+		// Collect the contracts in the order in which compileContract would visit them.
+		vector<ContractDefinition const*> contracts;
+		set<ContractDefinition const*> contractsSeen;
+		function<void(ContractDefinition const&)> collect = [&](ContractDefinition const& _contract)
+		{
+			if (contractsSeen.count(&_contract) || !isCompilableContract(_contract))
+				return;
+			contractsSeen.insert(&_contract);
+			for (auto const* dependency: _contract.annotation().contractDependencies)
+				collect(*dependency);
+			contracts.push_back(&_contract);
+		};
+		for (auto const* contract: requestedContracts)
+			collect(*contract);
+		compileContractsInParallel(contracts);
+	}
+
+	if (m_artifactCache)
+		for (auto const& contract: m_contracts)
+			if (contract.second.compiler && !contract.second.loadedFromCache)
+				storeArtifacts(contract.second);
+
 	this->link();
 	m_stackState = CompilationSuccessful;
 	return true;
@@ -353,14 +479,14 @@ vector<string> CompilerStack::contractNames() const
 
 eth::AssemblyItems const* CompilerStack::assemblyItems(string const& _contractName) const
 {
-	Contract const& currentContract = contract(_contractName);
-	return currentContract.compiler ? &contract(_contractName).compiler->assemblyItems() : nullptr;
+	shared_ptr<Compiler> const& compiler = contractCompiler(contract(_contractName));
+	return compiler ? &compiler->assemblyItems() : nullptr;
 }
 
 eth::AssemblyItems const* CompilerStack::runtimeAssemblyItems(string const& _contractName) const
 {
-	Contract const& currentContract = contract(_contractName);
-	return currentContract.compiler ? &contract(_contractName).compiler->runtimeAssemblyItems() : nullptr;
+	shared_ptr<Compiler> const& compiler = contractCompiler(contract(_contractName));
+	return compiler ? &compiler->runtimeAssemblyItems() : nullptr;
 }
 
 string const* CompilerStack::sourceMapping(string const& _contractName) const
@@ -419,9 +545,9 @@ eth::LinkerObject const& CompilerStack::runtimeObject(string const& _contractNam
 /// FIXME: cache this string
 string CompilerStack::assemblyString(string const& _contractName, StringMap _sourceCodes) const
 {
-	Contract const& currentContract = contract(_contractName);
-	if (currentContract.compiler)
-		return currentContract.compiler->assemblyString(_sourceCodes);
+	shared_ptr<Compiler> const& compiler = contractCompiler(contract(_contractName));
+	if (compiler)
+		return compiler->assemblyString(_sourceCodes);
 	else
 		return string();
 }
@@ -429,9 +555,9 @@ string CompilerStack::assemblyString(string const& _contractName, StringMap _sou
 /// FIXME: cache the JSON
 Json::Value CompilerStack::assemblyJSON(string const& _contractName, StringMap _sourceCodes) const
 {
-	Contract const& currentContract = contract(_contractName);
-	if (currentContract.compiler)
-		return currentContract.compiler->assemblyJSON(_sourceCodes);
+	shared_ptr<Compiler> const& compiler = contractCompiler(contract(_contractName));
+	if (compiler)
+		return compiler->assemblyJSON(_sourceCodes);
 	else
 		return Json::Value();
 }
@@ -520,10 +646,16 @@ Json::Value CompilerStack::methodIdentifiers(string const& _contractName) const
 
 string const& CompilerStack::metadata(string const& _contractName) const
 {
-	if (m_stackState != CompilationSuccessful)
-		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
+	if (m_stackState < AnalysisSuccessful)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Parsing was not successful."));
+
+	Contract const& currentContract = contract(_contractName);
 
-	return contract(_contractName).metadata;
+	// caches the result
+	if (currentContract.metadata.empty())
+		currentContract.metadata = createMetadata(currentContract);
+
+	return currentContract.metadata;
 }
 
 Scanner const& CompilerStack::scanner(string const& _sourceName) const
@@ -544,8 +676,8 @@ SourceUnit const& CompilerStack::ast(string const& _sourceName) const
 
 ContractDefinition const& CompilerStack::contractDefinition(string const& _contractName) const
 {
-	if (m_stackState != CompilationSuccessful)
-		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
+	if (m_stackState < AnalysisSuccessful)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Parsing was not successful."));
 
 	return *contract(_contractName).contract;
 }
@@ -555,7 +687,7 @@ size_t CompilerStack::functionEntryPoint(
 	FunctionDefinition const& _function
 ) const
 {
-	shared_ptr<Compiler> const& compiler = contract(_contractName).compiler;
+	shared_ptr<Compiler> const& compiler = contractCompiler(contract(_contractName));
 	if (!compiler)
 		return 0;
 	eth::AssemblyItem tag = compiler->functionEntryLabel(_function);
@@ -695,47 +827,185 @@ bool onlySafeExperimentalFeaturesActivated(set<ExperimentalFeature> const& featu
 }
 }
 
+bool CompilerStack::isCompilableContract(ContractDefinition const& _contract)
+{
+	return _contract.annotation().unimplementedFunctions.empty() && _contract.constructorIsPublic();
+}
+
 void CompilerStack::compileContract(
 	ContractDefinition const& _contract,
 	map<ContractDefinition const*, eth::Assembly const*>& _compiledContracts
 )
 {
-	if (
-		_compiledContracts.count(&_contract) ||
-		!_contract.annotation().unimplementedFunctions.empty() ||
-		!_contract.constructorIsPublic()
-	)
+	if (_compiledContracts.count(&_contract) || !isCompilableContract(_contract))
 		return;
 	for (auto const* dependency: _contract.annotation().contractDependencies)
 		compileContract(*dependency, _compiledContracts);
 
 	Contract& compiledContract = m_contracts.at(_contract.fullyQualifiedName());
+	generateContractCode(_contract, _compiledContracts);
+	optimiseAndAssembleContract(compiledContract, m_parallelism);
 
-	shared_ptr<Compiler> compiler = make_shared<Compiler>(m_evmVersion, m_optimize, m_optimizeRuns);
-	compiledContract.compiler = compiler;
+	_compiledContracts[compiledContract.contract] = &compiledContract.compiler->assembly();
+}
 
-	string metadata = createMetadata(compiledContract);
-	compiledContract.metadata = metadata;
+void CompilerStack::compileContractsInParallel(vector<ContractDefinition const*> const& _contracts)
+{
+	map<ContractDefinition const*, size_t> indices;
+	for (size_t i = 0; i < _contracts.size(); ++i)
+		indices[_contracts[i]] = i;
+	vector<vector<size_t>> dependencies(_contracts.size());
+	for (size_t i = 0; i < _contracts.size(); ++i)
+		for (auto const* dependency: _contracts[i]->annotation().contractDependencies)
+			if (indices.count(dependency))
+				dependencies[i].push_back(indices.at(dependency));
+
+	// The AST is not thread-safe, so code generation only happens while holding the mutex
+	// that also protects the scheduling state. Optimisation and assembly only access the
+	// assembly of the contract itself and run concurrently.
+	std::mutex schedulerMutex;
+	condition_variable stateChanged;
+	map<ContractDefinition const*, eth::Assembly const*> compiledContracts;
+	vector<bool> started(_contracts.size(), false);
+	vector<bool> finished(_contracts.size(), false);
+	vector<exception_ptr> failures(_contracts.size());
+	size_t finishedCount = 0;
+	bool failed = false;
+
+	// @returns the first contract in the serial order whose dependencies are all compiled.
+	auto nextContract = [&]() -> size_t
+	{
+		for (size_t i = 0; i < _contracts.size(); ++i)
+			if (!started[i] && all_of(
+				dependencies[i].begin(),
+				dependencies[i].end(),
+				[&](size_t _dependency) { return finished[_dependency]; }
+			))
+				return i;
+		return _contracts.size();
+	};
+
+	// The threads are shared between the contracts and their sub-assemblies, so that
+	// no more than m_parallelism threads run at the same time.
+	size_t const workerCount = min<size_t>(m_parallelism, _contracts.size());
+	unsigned const subAssemblyParallelism = max<unsigned>(1, m_parallelism / max<size_t>(1, workerCount));
+
+	TimingReport* timingReport = TimingReport::current();
+	auto worker = [&]()
+	{
+		TimingReport::Activation timingActivation(timingReport);
+		unique_lock<std::mutex> lock(schedulerMutex);
+		while (true)
+		{
+			size_t next = _contracts.size();
+			stateChanged.wait(lock, [&]() {
+				if (failed || finishedCount == _contracts.size())
+					return true;
+				next = nextContract();
+				return next < _contracts.size();
+			});
+			if (failed || finishedCount == _contracts.size())
+				return;
+
+			started[next] = true;
+			ContractDefinition const& contract = *_contracts[next];
+			Contract& compiledContract = m_contracts.at(contract.fullyQualifiedName());
+			try
+			{
+				generateContractCode(contract, compiledContracts);
+				lock.unlock();
+				optimiseAndAssembleContract(compiledContract, subAssemblyParallelism);
+				lock.lock();
+				compiledContracts[&contract] = &compiledContract.compiler->assembly();
+			}
+			catch (...)
+			{
+				if (!lock.owns_lock())
+					lock.lock();
+				failures[next] = current_exception();
+				failed = true;
+			}
+			finished[next] = true;
+			finishedCount++;
+			stateChanged.notify_all();
+		}
+	};
+
+	vector<thread> threads;
+	for (size_t i = 1; i < workerCount; ++i)
+		threads.emplace_back(worker);
+	worker();
+	for (auto& workerThread: threads)
+		workerThread.join();
+
+	// Report the failure of the contract that comes first in the serial order so that
+	// the error does not depend on the scheduling.
+	for (auto const& failure: failures)
+		if (failure)
+			rethrow_exception(failure);
+}
+
+void CompilerStack::generateContractCode(
+	ContractDefinition const& _contract,
+	map<ContractDefinition const*, eth::Assembly const*> const& _compiledContracts
+)
+{
+	Contract& compiledContract = m_contracts.at(_contract.fullyQualifiedName());
+	TimingScope timing("codeGeneration", _contract.fullyQualifiedName());
+	compiledContract.metadata = createMetadata(compiledContract);
+	compiledContract.compiler = generateCode(_contract, compiledContract.metadata, _compiledContracts);
+}
+
+shared_ptr<Compiler> CompilerStack::generateCode(
+	ContractDefinition const& _contract,
+	string const& _metadata,
+	map<ContractDefinition const*, eth::Assembly const*> const& _compiledContracts
+) const
+{
+	shared_ptr<Compiler> compiler = make_shared<Compiler>(
+		m_evmVersion,
+		m_optimize,
+		m_optimizeRuns,
+		m_optimizeControlFlow,
+		m_abiFunctionCache
+	);
 
 	bytes cborEncodedMetadata = createCBORMetadata(
-		metadata,
+		_metadata,
 		!onlySafeExperimentalFeaturesActivated(_contract.sourceUnit().annotation().experimentalFeatures)
 	);
 
 	try
 	{
-		// Run optimiser and compile the contract.
-		compiler->compileContract(_contract, _compiledContracts, cborEncodedMetadata);
+		compiler->generateCode(_contract, _compiledContracts, cborEncodedMetadata);
+	}
+	catch(eth::OptimizerException const&)
+	{
+		solAssert(false, "Optimizer exception during compilation");
+	}
+	return compiler;
+}
+
+void CompilerStack::optimiseAndAssembleContract(Contract& _contract, unsigned _parallelism)
+{
+	solAssert(_contract.compiler, "");
+
+	try
+	{
+		// Run optimiser.
+		TimingScope timing("optimisation", _contract.contract->fullyQualifiedName());
+		_contract.compiler->optimise(_parallelism);
 	}
 	catch(eth::OptimizerException const&)
 	{
 		solAssert(false, "Optimizer exception during compilation");
 	}
 
+	TimingScope timing("assembly", _contract.contract->fullyQualifiedName());
 	try
 	{
 		// Assemble deployment (incl. runtime)  object.
-		compiledContract.object = compiler->assembledObject();
+		_contract.object = _contract.compiler->assembledObject();
 	}
 	catch(eth::AssemblyException const&)
 	{
@@ -745,14 +1015,222 @@ void CompilerStack::compileContract(
 	try
 	{
 		// Assemble runtime object.
-		compiledContract.runtimeObject = compiler->runtimeObject();
+		_contract.runtimeObject = _contract.compiler->runtimeObject();
 	}
 	catch(eth::AssemblyException const&)
 	{
 		solAssert(false, "Assembly exception for deployed bytecode");
 	}
+}
+
+shared_ptr<Compiler> const& CompilerStack::contractCompiler(Contract const& _contract) const
+{
+	if (!_contract.compiler && _contract.loadedFromCache)
+		regenerateCode(_contract);
+	return _contract.compiler;
+}
+
+void CompilerStack::regenerateCode(Contract const& _contract) const
+{
+	if (_contract.compiler)
+		return;
+
+	solAssert(_contract.contract, "");
+	map<ContractDefinition const*, eth::Assembly const*> compiledContracts;
+	for (auto const* dependency: _contract.contract->annotation().contractDependencies)
+	{
+		Contract const& compiledDependency = m_contracts.at(dependency->fullyQualifiedName());
+		regenerateCode(compiledDependency);
+		compiledContracts[dependency] = &compiledDependency.compiler->assembly();
+	}
+
+	shared_ptr<Compiler> compiler = generateCode(
+		*_contract.contract,
+		_contract.metadata.empty() ? createMetadata(_contract) : _contract.metadata,
+		compiledContracts
+	);
+	try
+	{
+		compiler->optimise();
+	}
+	catch(eth::OptimizerException const&)
+	{
+		solAssert(false, "Optimizer exception during compilation");
+	}
+	// Assembling caches the object in the assembly, which is then copied into the contracts
+	// that create this contract, exactly as during compilation.
+	compiler->assembledObject();
+	_contract.compiler = compiler;
+}
+
+namespace
+{
+
+/// @returns the names of the source unit of the contract and of all source units it references.
+set<string> referencedSources(ContractDefinition const& _contract)
+{
+	set<string> sources;
+	sources.insert(_contract.sourceUnit().annotation().path);
+	for (auto const sourceUnit: _contract.sourceUnit().referencedSourceUnits(true))
+		sources.insert(sourceUnit->annotation().path);
+	return sources;
+}
+
+/// @returns indices into the sorted list of the sources the contract references. Unlike the
+/// global source indices, they do not depend on sources that are unrelated to the contract.
+map<string, unsigned> relativeSourceIndices(ContractDefinition const& _contract)
+{
+	map<string, unsigned> indices;
+	for (string const& source: referencedSources(_contract))
+		indices.insert(make_pair(source, indices.size()));
+	return indices;
+}
+
+/// Replaces the source indices in the source mapping @a _sourceMapping by @a _newIndices.
+/// Because the replacement is injective, the compression of the mapping stays valid.
+string translateSourceIndices(string const& _sourceMapping, map<int, int> const& _newIndices)
+{
+	vector<string> items;
+	boost::split(items, _sourceMapping, boost::is_any_of(";"));
+	for (string& item: items)
+	{
+		vector<string> components;
+		boost::split(components, item, boost::is_any_of(":"));
+		if (components.size() >= 3 && !components[2].empty() && components[2] != "-1")
+		{
+			auto index = _newIndices.find(stoi(components[2]));
+			components[2] = index == _newIndices.end() ? "-1" : to_string(index->second);
+			item = boost::algorithm::join(components, ":");
+		}
+	}
+	return boost::algorithm::join(items, ";");
+}
+
+Json::Value linkerObjectToJson(eth::LinkerObject const& _object)
+{
+	Json::Value ret(Json::objectValue);
+	ret["object"] = toHex(_object.bytecode);
+	ret["linkReferences"] = Json::objectValue;
+	for (auto const& reference: _object.linkReferences)
+		ret["linkReferences"][to_string(reference.first)] = reference.second;
+	return ret;
+}
+
+bool linkerObjectFromJson(Json::Value const& _json, eth::LinkerObject& _object)
+{
+	if (!_json.isObject() || !_json["object"].isString() || !_json["linkReferences"].isObject())
+		return false;
+	// A truncated or corrupt entry is treated as missing.
+	try
+	{
+		_object.bytecode = fromHex(_json["object"].asString(), WhenError::Throw);
+		if (_object.bytecode.empty())
+			return false;
+		_object.linkReferences.clear();
+		for (auto const& offset: _json["linkReferences"].getMemberNames())
+		{
+			if (
+				!_json["linkReferences"][offset].isString() ||
+				offset.empty() ||
+				!all_of(offset.begin(), offset.end(), [](char _c) { return isdigit(_c); })
+			)
+				return false;
+			size_t position = stoul(offset);
+			// The placeholder of a library address takes 20 bytes.
+			if (position > _object.bytecode.size() || _object.bytecode.size() - position < 20)
+				return false;
+			_object.linkReferences[position] = _json["linkReferences"][offset].asString();
+		}
+	}
+	catch (BadHexCharacter const&)
+	{
+		return false;
+	}
+	catch (out_of_range const&)
+	{
+		return false;
+	}
+	return true;
+}
+
+}
 
-	_compiledContracts[compiledContract.contract] = &compiler->assembly();
+h256 CompilerStack::artifactKey(string const& _metadata)
+{
+	return dev::keccak256(string(VersionString) + "\n" + _metadata);
+}
+
+bool CompilerStack::loadArtifacts(Contract& _contract)
+{
+	if (!m_artifactCache || !isCompilableContract(*_contract.contract))
+		return false;
+
+	string metadata = createMetadata(_contract);
+	Json::Value entry = m_artifactCache->load(artifactKey(metadata));
+	if (!entry.isObject() || !entry["sourceMap"].isString() || !entry["deployedSourceMap"].isString())
+		return false;
+	eth::LinkerObject object;
+	eth::LinkerObject runtimeObject;
+	if (
+		!linkerObjectFromJson(entry["bytecode"], object) ||
+		!linkerObjectFromJson(entry["deployedBytecode"], runtimeObject)
+	)
+		return false;
+
+	// The source mappings are stored using relative source indices.
+	map<string, unsigned> globalIndices = sourceIndices();
+	map<int, int> toGlobalIndices;
+	for (auto const& source: relativeSourceIndices(*_contract.contract))
+		toGlobalIndices[source.second] = globalIndices.at(source.first);
+
+	string sourceMapping;
+	string runtimeSourceMapping;
+	try
+	{
+		sourceMapping = translateSourceIndices(entry["sourceMap"].asString(), toGlobalIndices);
+		runtimeSourceMapping = translateSourceIndices(entry["deployedSourceMap"].asString(), toGlobalIndices);
+	}
+	catch (logic_error const&)
+	{
+		// Source index that is not a number (invalid_argument) or too large (out_of_range).
+		return false;
+	}
+
+	_contract.metadata = metadata;
+	_contract.object = move(object);
+	_contract.runtimeObject = move(runtimeObject);
+	_contract.sourceMapping.reset(new string(move(sourceMapping)));
+	_contract.runtimeSourceMapping.reset(new string(move(runtimeSourceMapping)));
+	_contract.loadedFromCache = true;
+	return true;
+}
+
+void CompilerStack::storeArtifacts(Contract const& _contract) const
+{
+	solAssert(m_artifactCache && _contract.compiler, "");
+
+	map<string, unsigned> relativeIndices = relativeSourceIndices(*_contract.contract);
+	string sourceMap = computeSourceMapping(_contract.compiler->assemblyItems(), relativeIndices);
+	string runtimeSourceMap = computeSourceMapping(_contract.compiler->runtimeAssemblyItems(), relativeIndices);
+
+	// Do not store the contract if its code refers to sources it does not depend on,
+	// because these references cannot be represented by relative indices.
+	map<string, unsigned> globalIndices = sourceIndices();
+	map<int, int> toGlobalIndices;
+	for (auto const& source: relativeIndices)
+		toGlobalIndices[source.second] = globalIndices.at(source.first);
+	if (
+		translateSourceIndices(sourceMap, toGlobalIndices) != *sourceMapping(_contract.contract->fullyQualifiedName()) ||
+		translateSourceIndices(runtimeSourceMap, toGlobalIndices) != *runtimeSourceMapping(_contract.contract->fullyQualifiedName())
+	)
+		return;
+
+	Json::Value entry(Json::objectValue);
+	entry["bytecode"] = linkerObjectToJson(_contract.object);
+	entry["deployedBytecode"] = linkerObjectToJson(_contract.runtimeObject);
+	entry["sourceMap"] = sourceMap;
+	entry["deployedSourceMap"] = runtimeSourceMap;
+	m_artifactCache->store(artifactKey(_contract.metadata), entry);
 }
 
 string const CompilerStack::lastContractName() const
@@ -817,20 +1295,16 @@ string CompilerStack::createMetadata(Contract const& _contract) const
 	meta["compiler"]["version"] = VersionStringStrict;
 
 	/// All the source files (including self), which should be included in the metadata.
-	set<string> referencedSources;
-	referencedSources.insert(_contract.contract->sourceUnit().annotation().path);
-	for (auto const sourceUnit: _contract.contract->sourceUnit().referencedSourceUnits(true))
-		referencedSources.insert(sourceUnit->annotation().path);
+	set<string> sources = referencedSources(*_contract.contract);
 
 	meta["sources"] = Json::objectValue;
 	for (auto const& s: m_sources)
 	{
-		if (!referencedSources.count(s.first))
+		if (!sources.count(s.first))
 			continue;
 
 		solAssert(s.second.scanner, "Scanner not available");
-		meta["sources"][s.first]["keccak256"] =
-			"0x" + toHex(dev::keccak256(s.second.scanner->source()).asBytes());
+		meta["sources"][s.first]["keccak256"] = "0x" + toHex(s.second.contentHash.asBytes());
 		if (m_metadataLiteralSources)
 			meta["sources"][s.first]["content"] = s.second.scanner->source();
 		else
@@ -843,6 +1317,8 @@ string CompilerStack::createMetadata(Contract const& _contract) const
 	}
 	meta["settings"]["optimizer"]["enabled"] = m_optimize;
 	meta["settings"]["optimizer"]["runs"] = m_optimizeRuns;
+	if (m_optimize && m_optimizeControlFlow)
+		meta["settings"]["optimizer"]["controlFlow"] = true;
 	meta["settings"]["evmVersion"] = m_evmVersion.name();
 	meta["settings"]["compilationTarget"][_contract.contract->sourceUnitName()] =
 		_contract.contract->annotation().canonicalName;
@@ -891,13 +1367,22 @@ bytes CompilerStack::createCBORMetadata(string _metadata, bool _experimentalMode
 }
 
 string CompilerStack::computeSourceMapping(eth::AssemblyItems const& _items) const
+{
+	return computeSourceMapping(_items, sourceIndices());
+}
+
+string CompilerStack::computeSourceMapping(
+	eth::AssemblyItems const& _items,
+	map<string, unsigned> const& _sourceIndices
+)
 {
 	string ret;
-	map<string, unsigned> sourceIndicesMap = sourceIndices();
 	int prevStart = -1;
 	int prevLength = -1;
 	int prevSourceIndex = -1;
 	char prevJump = 0;
+	// Source names are interned, so their indices can be cached by address.
+	unordered_map<string const*, int> indexCache;
 	for (auto const& item: _items)
 	{
 		if (!ret.empty())
@@ -905,10 +1390,17 @@ string CompilerStack::computeSourceMapping(eth::AssemblyItems const& _items) con
 
 		SourceLocation const& location = item.location();
 		int length = location.start != -1 && location.end != -1 ? location.end - location.start : -1;
-		int sourceIndex =
-			location.sourceName && sourceIndicesMap.count(*location.sourceName) ?
-			sourceIndicesMap.at(*location.sourceName) :
-			-1;
+		int sourceIndex = -1;
+		if (location.sourceName)
+		{
+			auto cached = indexCache.find(location.sourceName);
+			if (cached == indexCache.end())
+			{
+				auto it = _sourceIndices.find(*location.sourceName);
+				cached = indexCache.emplace(location.sourceName, it == _sourceIndices.end() ? -1 : int(it->second)).first;
+			}
+			sourceIndex = cached->second;
+		}
 		char jump = '-';
 		if (item.getJumpType() == eth::AssemblyItem::JumpType::IntoFunction)
 			jump = 'i';
@@ -974,6 +1466,41 @@ Json::Value gasToJson(GasEstimator::GasConsumption const& _gas)
 		return Json::Value(toString(_gas.value));
 }
 
+/// Runs the given estimations on up to @a _parallelism threads.
+vector<GasEstimator::GasConsumption> estimateInParallel(
+	vector<function<GasEstimator::GasConsumption()>> const& _estimations,
+	unsigned _parallelism
+)
+{
+	vector<GasEstimator::GasConsumption> results(_estimations.size());
+	atomic<size_t> nextEstimation{0};
+	vector<exception_ptr> failures(_estimations.size());
+	auto worker = [&]()
+	{
+		for (size_t i = nextEstimation++; i < _estimations.size(); i = nextEstimation++)
+			try
+			{
+				results[i] = _estimations[i]();
+			}
+			catch (...)
+			{
+				failures[i] = current_exception();
+			}
+	};
+	vector<thread> threads;
+	for (size_t i = 1; i < min<size_t>(_parallelism, _estimations.size()); ++i)
+		threads.emplace_back(worker);
+	worker();
+	for (auto& workerThread: threads)
+		workerThread.join();
+
+	// Report the failure of the first estimation to be independent of the scheduling.
+	for (auto const& failure: failures)
+		if (failure)
+			rethrow_exception(failure);
+	return results;
+}
+
 }
 
 Json::Value CompilerStack::gasEstimates(string const& _contractName) const
@@ -981,6 +1508,7 @@ Json::Value CompilerStack::gasEstimates(string const& _contractName) const
 	if (!assemblyItems(_contractName) && !runtimeAssemblyItems(_contractName))
 		return Json::Value();
 
+	TimingScope timing("gasEstimation", _contractName);
 	using Gas = GasEstimator::GasConsumption;
 	GasEstimator gasEstimator(m_evmVersion);
 	Json::Value output(Json::objectValue);
@@ -1001,37 +1529,41 @@ Json::Value CompilerStack::gasEstimates(string const& _contractName) const
 
 	if (eth::AssemblyItems const* items = runtimeAssemblyItems(_contractName))
 	{
-		/// External functions
+		// Calls to internal functions are estimated once and shared between all estimations,
+		// which run in parallel. Everything that needs the AST is collected beforehand.
 		ContractDefinition const& contract = contractDefinition(_contractName);
-		Json::Value externalFunctions(Json::objectValue);
+		eth::FunctionGasSummaries functions(*items);
+		for (auto const& definedFunction: contract.definedFunctions())
+			if (size_t entry = functionEntryPoint(_contractName, *definedFunction))
+				functions.registerFunction(items->at(entry).data(), CompilerUtils::sizeOnStack(definedFunction->parameters()));
+		GasEstimator runtimeEstimator(m_evmVersion, &functions);
+		vector<pair<string, bool>> signatures;
+		vector<function<Gas()>> estimations;
+
+		/// External functions
 		for (auto it: contract.interfaceFunctions())
 		{
 			string sig = it.second->externalSignature();
-			externalFunctions[sig] = gasToJson(gasEstimator.functionalEstimation(*items, sig));
+			signatures.emplace_back(sig, true);
+			estimations.push_back([=, &runtimeEstimator]() { return runtimeEstimator.functionalEstimation(*items, sig); });
 		}
 
 		if (contract.fallbackFunction())
+		{
 			/// This needs to be set to an invalid signature in order to trigger the fallback,
 			/// without the shortcut (of CALLDATSIZE == 0), and therefore to receive the upper bound.
 			/// An empty string ("") would work to trigger the shortcut only.
-			externalFunctions[""] = gasToJson(gasEstimator.functionalEstimation(*items, "INVALID"));
-
-		if (!externalFunctions.empty())
-			output["external"] = externalFunctions;
+			signatures.emplace_back("", true);
+			estimations.push_back([=, &runtimeEstimator]() { return runtimeEstimator.functionalEstimation(*items, "INVALID"); });
+		}
 
 		/// Internal functions
-		Json::Value internalFunctions(Json::objectValue);
 		for (auto const& it: contract.definedFunctions())
 		{
 			/// Exclude externally visible functions, constructor and the fallback function
 			if (it->isPartOfExternalInterface() || it->isConstructor() || it->isFallback())
 				continue;
 
-			size_t entry = functionEntryPoint(_contractName, *it);
-			GasEstimator::GasConsumption gas = GasEstimator::GasConsumption::infinite();
-			if (entry > 0)
-				gas = gasEstimator.functionalEstimation(*items, entry, *it);
-
 			/// TODO: This could move into a method shared with externalSignature()
 			FunctionType type(*it);
 			string sig = it->name() + "(";
@@ -1039,10 +1571,25 @@ Json::Value CompilerStack::gasEstimates(string const& _contractName) const
 			for (auto it = paramTypes.begin(); it != paramTypes.end(); ++it)
 				sig += (*it)->toString() + (it + 1 == paramTypes.end() ? "" : ",");
 			sig += ")";
+			signatures.emplace_back(sig, false);
 
-			internalFunctions[sig] = gasToJson(gas);
+			size_t entry = functionEntryPoint(_contractName, *it);
+			unsigned parameters = CompilerUtils::sizeOnStack(it->parameters());
+			estimations.push_back([=, &runtimeEstimator]() {
+				if (entry == 0)
+					return Gas::infinite();
+				return runtimeEstimator.functionalEstimation(*items, entry, parameters);
+			});
 		}
 
+		vector<Gas> gas = estimateInParallel(estimations, m_parallelism);
+		Json::Value externalFunctions(Json::objectValue);
+		Json::Value internalFunctions(Json::objectValue);
+		for (size_t i = 0; i < signatures.size(); ++i)
+			(signatures[i].second ? externalFunctions : internalFunctions)[signatures[i].first] = gasToJson(gas[i]);
+
+		if (!externalFunctions.empty())
+			output["external"] = externalFunctions;
 		if (!internalFunctions.empty())
 			output["internal"] = internalFunctions;
 	}
@@ -63,6 +63,8 @@ class ContractDefinition;
 class FunctionDefinition;
 class SourceUnit;
 class Compiler;
+class ArtifactCache;
+class ABIFunctionCache;
 class GlobalContext;
 class Natspec;
 class Error;
@@ -123,14 +125,29 @@ public:
 		m_libraries = _libraries;
 	}
 
-	/// Changes the optimiser settings.
+	/// Changes the optimiser settings. @a _controlFlow enables the optimisation across basic
+	/// blocks, which is only done if @a _optimize is set.
 	/// Will not take effect before running compile.
-	void setOptimiserSettings(bool _optimize, unsigned _runs = 200)
+	void setOptimiserSettings(bool _optimize, unsigned _runs = 200, bool _controlFlow = false)
 	{
 		m_optimize = _optimize;
 		m_optimizeRuns = _runs;
+		m_optimizeControlFlow = _controlFlow;
 	}
 
+	/// Sets the number of threads used to generate, optimise and assemble the code of contracts
+	/// and to optimise the sub-assemblies (e.g. contracts created via "new") of each contract.
+	/// Contracts are still compiled after the contracts they create. The result does not depend
+	/// on this setting. Zero and one both mean that everything is done on the calling thread.
+	/// Will not take effect before running compile.
+	void setParallelism(unsigned _jobs = 1) { m_parallelism = _jobs; }
+
+	/// Sets the cache from which the bytecode and source mappings of contracts are loaded if
+	/// nothing they depend on has changed, and into which newly compiled contracts are stored.
+	/// The code of cached contracts is only generated if their assembly is requested.
+	/// This is not reset by reset().
+	void setArtifactCache(std::shared_ptr<ArtifactCache> _cache = nullptr) { m_artifactCache = std::move(_cache); }
+
 	/// Set the EVM version used before running compile.
 	/// When called without an argument it will revert to the default version.
 	void setEVMVersion(EVMVersion _version = EVMVersion{});
@@ -145,6 +162,18 @@ public:
 	/// @arg _metadataLiteralSources When true, store sources as literals in the contract metadata.
 	void useMetadataLiteralSources(bool _metadataLiteralSources) { m_metadataLiteralSources = _metadataLiteralSources; }
 
+	/// Enables or disables incremental parsing. If enabled, the syntax trees of successfully parsed
+	/// sources are kept, even across calls to reset(), and reused if a source with the same name
+	/// and content is parsed again, unless the sources parsed before it now contain a different
+	/// number of nodes. The analysis is still performed for all sources. AST node IDs are thus
+	/// the same as without incremental parsing.
+	void useIncrementalParsing(bool _incrementalParsing)
+	{
+		m_incrementalParsing = _incrementalParsing;
+		if (!_incrementalParsing)
+			m_parsedSources.clear();
+	}
+
 	/// Adds a source object (e.g. file) to the parser. After this, parse has to be called again.
 	/// @returns true if a source object by the name already existed and was replaced.
 	bool addSource(std::string const& _name, std::string const& _content, bool _isLibrary = false);
@@ -239,6 +268,7 @@ public:
 	Json::Value methodIdentifiers(std::string const& _contractName) const;
 
 	/// @returns the Contract Metadata
+	/// Prerequisite: Successful call to parse or compile.
 	std::string const& metadata(std::string const& _contractName) const;
 
 	/// @returns a JSON representing the estimated gas usage for contract creation, internal and external functions
@@ -250,6 +280,9 @@ private:
 	{
 		std::shared_ptr<Scanner> scanner;
 		std::shared_ptr<SourceUnit> ast;
+		h256 contentHash; ///< keccak256 hash of the source code.
+		size_t firstNodeID = 0; ///< ID the first AST node of this source received or would receive.
+		size_t nodeIDsEnd = 0; ///< Value of the AST node ID counter after parsing this source.
 		bool isLibrary = false;
 		void reset() { scanner.reset(); ast.reset(); }
 	};
@@ -258,10 +291,12 @@ private:
 	struct Contract
 	{
 		ContractDefinition const* contract = nullptr;
-		std::shared_ptr<Compiler> compiler;
+		/// Only generated on demand if the contract was loaded from the artifact cache.
+		mutable std::shared_ptr<Compiler> compiler;
+		bool loadedFromCache = false;
 		eth::LinkerObject object; ///< Deployment object (includes the runtime sub-object).
 		eth::LinkerObject runtimeObject; ///< Runtime object.
-		std::string metadata; ///< The metadata json that will be hashed into the chain.
+		mutable std::string metadata; ///< The metadata json that will be hashed into the chain.
 		mutable std::unique_ptr<Json::Value const> abi;
 		mutable std::unique_ptr<Json::Value const> userDocumentation;
 		mutable std::unique_ptr<Json::Value const> devDocumentation;
@@ -279,12 +314,59 @@ private:
 	/// @returns true if the contract is requested to be compiled.
 	bool isRequestedContract(ContractDefinition const& _contract) const;
 
+	/// @returns true if code can be generated for the contract.
+	static bool isCompilableContract(ContractDefinition const& _contract);
+
 	/// Compile a single contract and put the result in @a _compiledContracts.
 	void compileContract(
 		ContractDefinition const& _contract,
 		std::map<ContractDefinition const*, eth::Assembly const*>& _compiledContracts
 	);
 
+	/// Compiles the given contracts using m_parallelism threads. @a _contracts has to be
+	/// ordered such that every contract comes after the contracts it depends on.
+	void compileContractsInParallel(std::vector<ContractDefinition const*> const& _contracts);
+
+	/// Creates the metadata of a single contract and generates its unoptimised code.
+	/// All contracts it depends on have to be present in @a _compiledContracts.
+	void generateContractCode(
+		ContractDefinition const& _contract,
+		std::map<ContractDefinition const*, eth::Assembly const*> const& _compiledContracts
+	);
+
+	/// Optimises and assembles a contract whose code has been generated already, optimising
+	/// its sub-assemblies on up to @a _parallelism threads.
+	/// Does not access the AST and can run concurrently for different contracts.
+	void optimiseAndAssembleContract(Contract& _contract, unsigned _parallelism);
+
+	/// @returns a compiler that has generated the unoptimised code of @a _contract, given
+	/// the serialised metadata of the contract.
+	std::shared_ptr<Compiler> generateCode(
+		ContractDefinition const& _contract,
+		std::string const& _metadata,
+		std::map<ContractDefinition const*, eth::Assembly const*> const& _compiledContracts
+	) const;
+
+	/// @returns the compiler of the contract. For contracts loaded from the artifact cache,
+	/// the code is generated and optimised on the first call.
+	std::shared_ptr<Compiler> const& contractCompiler(Contract const& _contract) const;
+
+	/// Generates and optimises the code of @a _contract and the contracts it depends on,
+	/// unless this has been done already. Does not modify the assembled objects.
+	void regenerateCode(Contract const& _contract) const;
+
+	/// @returns the key of the contract in the artifact cache. It is derived from the metadata,
+	/// which contains the hashes of all sources the contract depends on and all settings
+	/// that influence the generated code, and from the full version string of the compiler.
+	static h256 artifactKey(std::string const& _metadata);
+
+	/// Computes the metadata of @a _contract and tries to load its artifacts from the cache.
+	/// @returns false if no cache is set or if there is no usable entry.
+	bool loadArtifacts(Contract& _contract);
+
+	/// Stores the artifacts of a compiled contract in the cache.
+	void storeArtifacts(Contract const& _contract) const;
+
 	/// Links all the known library addresses in the available objects. Any unknown
 	/// library will still be kept as an unlinked placeholder in the objects.
 	void link();
@@ -309,6 +391,11 @@ private:
 
 	/// @returns the computer source mapping string.
 	std::string computeSourceMapping(eth::AssemblyItems const& _items) const;
+	/// @returns the computer source mapping string using the given indices of the sources.
+	static std::string computeSourceMapping(
+		eth::AssemblyItems const& _items,
+		std::map<std::string, unsigned> const& _sourceIndices
+	);
 
 	/// @returns the contract ABI as a JSON object.
 	/// This will generate the JSON object and store it in the Contract object if it is not present yet.
@@ -333,6 +420,11 @@ private:
 	ReadCallback::Callback m_smtQuery;
 	bool m_optimize = false;
 	unsigned m_optimizeRuns = 200;
+	bool m_optimizeControlFlow = false;
+	unsigned m_parallelism = 1;
+	std::shared_ptr<ArtifactCache> m_artifactCache;
+	/// Functions generated for ABI encoding and decoding, shared by the contracts of a compilation.
+	std::shared_ptr<ABIFunctionCache> m_abiFunctionCache;
 	EVMVersion m_evmVersion;
 	std::set<std::string> m_requestedContractNames;
 	std::map<std::string, h160> m_libraries;
@@ -341,6 +433,8 @@ private:
 	std::vector<Remapping> m_remappings;
 	std::map<std::string const, Source> m_sources;
 	std::shared_ptr<GlobalContext> m_globalContext;
+	/// Source of the IDs of the AST nodes created by this compiler stack.
+	size_t m_nodeIDCounter = 0;
 	std::vector<Source const*> m_sourceOrder;
 	/// This is updated during compilation.
 	std::map<ASTNode const*, std::shared_ptr<DeclarationContainer>> m_scopes;
@@ -348,6 +442,9 @@ private:
 	ErrorList m_errorList;
 	ErrorReporter m_errorReporter;
 	bool m_metadataLiteralSources = false;
+	bool m_incrementalParsing = false;
+	/// Successfully parsed sources of the last call to parse(), only used for incremental parsing.
+	std::map<std::string const, Source> m_parsedSources;
 	State m_stackState = Empty;
 };
 
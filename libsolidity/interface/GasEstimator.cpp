@@ -160,7 +160,7 @@ GasEstimator::GasConsumption GasEstimator::functionalEstimation(
 		);
 	}
 
-	return PathGasMeter::estimateMax(_items, m_evmVersion, 0, state);
+	return PathGasMeter(_items, m_evmVersion, m_functions, m_explorationBudget).estimateMax(0, state);
 }
 
 GasEstimator::GasConsumption GasEstimator::functionalEstimation(
@@ -169,20 +169,32 @@ GasEstimator::GasConsumption GasEstimator::functionalEstimation(
 	FunctionDefinition const& _function
 ) const
 {
-	auto state = make_shared<KnownState>();
+	return functionalEstimation(_items, _offset, CompilerUtils::sizeOnStack(_function.parameters()));
+}
 
-	unsigned parametersSize = CompilerUtils::sizeOnStack(_function.parameters());
-	if (parametersSize > 16)
+GasEstimator::GasConsumption GasEstimator::functionalEstimation(
+	AssemblyItems const& _items,
+	size_t const& _offset,
+	unsigned _parameters
+) const
+{
+	if (_parameters > 16)
 		return GasConsumption::infinite();
 
+	PathGasMeter meter(_items, m_evmVersion, m_functions, m_explorationBudget);
+	if (m_functions && _items.at(_offset).type() == Tag && m_functions->parameters(_items.at(_offset).data()))
+		return meter.functionSummary(_items.at(_offset).data(), 0)->gas;
+
+	auto state = make_shared<KnownState>();
+
 	// Store an invalid return value on the stack, so that the path estimator breaks upon reaching
 	// the return jump.
 	AssemblyItem invalidTag(PushTag, u256(-0x10));
 	state->feedItem(invalidTag, true);
-	if (parametersSize > 0)
-		state->feedItem(swapInstruction(parametersSize));
+	if (_parameters > 0)
+		state->feedItem(swapInstruction(_parameters));
 
-	return PathGasMeter::estimateMax(_items, m_evmVersion, _offset, state);
+	return meter.estimateMax(_offset, state);
 }
 
 set<ASTNode const*> GasEstimator::finestNodesAtLocation(
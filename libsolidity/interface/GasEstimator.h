@@ -26,6 +26,7 @@
 
 #include <libevmasm/GasMeter.h>
 #include <libevmasm/Assembly.h>
+#include <libevmasm/PathGasMeter.h>
 
 #include <vector>
 #include <map>
@@ -47,7 +48,16 @@ public:
 	using ASTGasConsumptionSelfAccumulated =
 		std::map<ASTNode const*, std::array<GasConsumption, 2>>;
 
-	explicit GasEstimator(EVMVersion _evmVersion): m_evmVersion(_evmVersion) {}
+	/// @param _functions if given, calls to the internal functions registered there are estimated
+	/// only once and shared between all functional estimations.
+	/// @param _explorationBudget number of assembly items after which a functional estimation
+	/// gives up and reports infinite gas.
+	explicit GasEstimator(
+		EVMVersion _evmVersion,
+		eth::FunctionGasSummaries* _functions = nullptr,
+		size_t _explorationBudget = eth::PathGasMeter::defaultExplorationBudget
+	):
+		m_evmVersion(_evmVersion), m_functions(_functions), m_explorationBudget(_explorationBudget) {}
 
 	/// Estimates the gas consumption for every assembly item in the given assembly and stores
 	/// it by source location.
@@ -80,11 +90,21 @@ public:
 		size_t const& _offset,
 		FunctionDefinition const& _function
 	) const;
+	/// @returns the estimated gas consumption by the function which starts at the given offset
+	/// into the list of assembly items and expects @a _parameters stack slots above its return address.
+	/// Does not access the AST and can thus be used from multiple threads.
+	GasConsumption functionalEstimation(
+		eth::AssemblyItems const& _items,
+		size_t const& _offset,
+		unsigned _parameters
+	) const;
 
 private:
 	/// @returns the set of AST nodes which are the finest nodes at their location.
 	static std::set<ASTNode const*> finestNodesAtLocation(std::vector<ASTNode const*> const& _roots);
 	EVMVersion m_evmVersion;
+	eth::FunctionGasSummaries* m_functions = nullptr;
+	size_t m_explorationBudget;
 };
 
 }
@@ -26,6 +26,7 @@
 #include <libevmasm/Instruction.h>
 #include <libdevcore/JSON.h>
 #include <libdevcore/SHA3.h>
+#include <libdevcore/TimingReport.h>
 
 #include <boost/algorithm/string.hpp>
 
@@ -63,6 +64,31 @@ Json::Value formatFatalError(string const& _type, string const& _message)
 	return output;
 }
 
+/// @returns the fatal error output for the exception that is currently being handled.
+Json::Value formatCurrentException()
+{
+	try
+	{
+		throw;
+	}
+	catch (Json::LogicError const& _exception)
+	{
+		return formatFatalError("InternalCompilerError", string("JSON logic exception: ") + _exception.what());
+	}
+	catch (Json::RuntimeError const& _exception)
+	{
+		return formatFatalError("InternalCompilerError", string("JSON runtime exception: ") + _exception.what());
+	}
+	catch (Exception const& _exception)
+	{
+		return formatFatalError("InternalCompilerError", "Internal exception in StandardCompiler::compileInternal: " + boost::diagnostic_information(_exception));
+	}
+	catch (...)
+	{
+		return formatFatalError("InternalCompilerError", "Internal exception in StandardCompiler::compileInternal");
+	}
+}
+
 Json::Value formatErrorWithException(
 	Exception const& _exception,
 	bool const& _warning,
@@ -94,22 +120,6 @@ Json::Value formatErrorWithException(
 	return formatError(_warning, _type, _component, message, formattedMessage, sourceLocation);
 }
 
-set<string> requestedContractNames(Json::Value const& _outputSelection)
-{
-	set<string> names;
-	for (auto const& sourceName: _outputSelection.getMemberNames())
-	{
-		for (auto const& contractName: _outputSelection[sourceName].getMemberNames())
-		{
-			/// Consider the "all sources" shortcuts as requesting everything.
-			if (contractName == "*" || contractName == "")
-				return set<string>();
-			names.insert((sourceName == "*" ? "" : sourceName) + ":" + contractName);
-		}
-	}
-	return names;
-}
-
 /// Returns true iff @a _hash (hex with 0x prefix) is the Keccak256 hash of the binary data in @a _content.
 bool hashMatchesContent(string const& _hash, string const& _content)
 {
@@ -188,6 +198,67 @@ bool isArtifactRequested(Json::Value const& _outputSelection, string const& _fil
 	return false;
 }
 
+/// @returns true if any of the artifacts in the array @a _artifacts can only be
+/// produced by generating code, i.e. the compiler cannot stop after analysis.
+bool requiresBinary(Json::Value const& _artifacts)
+{
+	// This does not include "evm.methodIdentifiers" and "metadata" on purpose,
+	// they are available after analysis.
+	static vector<string> const outputsThatRequireBinaries{
+		"evm.assembly", "evm.legacyAssembly", "evm.gasEstimates",
+		"evm.bytecode", "evm.bytecode.object", "evm.bytecode.opcodes", "evm.bytecode.sourceMap", "evm.bytecode.linkReferences",
+		"evm.deployedBytecode", "evm.deployedBytecode.object", "evm.deployedBytecode.opcodes", "evm.deployedBytecode.sourceMap", "evm.deployedBytecode.linkReferences"
+	};
+
+	for (auto const& artifact: outputsThatRequireBinaries)
+		if (isArtifactRequested(_artifacts, artifact))
+			return true;
+	return false;
+}
+
+/// @returns the names of the contracts for which code has to be generated because a binary
+/// artifact is requested for them. Their dependencies are compiled by the compiler stack.
+/// An empty set means all contracts, use isBinaryRequested() to check whether any code is needed at all.
+set<string> requestedContractNames(Json::Value const& _outputSelection)
+{
+	set<string> names;
+	if (!_outputSelection.isObject())
+		return names;
+	for (auto const& sourceName: _outputSelection.getMemberNames())
+	{
+		if (!_outputSelection[sourceName].isObject())
+			continue;
+		for (auto const& contractName: _outputSelection[sourceName].getMemberNames())
+		{
+			Json::Value const& artifacts = _outputSelection[sourceName][contractName];
+			/// Source-level targets (such as AST) never need code.
+			if (contractName.empty() || !artifacts.isArray() || !requiresBinary(artifacts))
+				continue;
+			/// Consider the "all contracts" shortcut as requesting everything.
+			if (contractName == "*")
+				return set<string>();
+			names.insert((sourceName == "*" ? "" : sourceName) + ":" + contractName);
+		}
+	}
+	return names;
+}
+
+/// @returns true if code has to be generated for any contract to satisfy @a _outputSelection.
+bool isBinaryRequested(Json::Value const& _outputSelection)
+{
+	if (!_outputSelection.isObject())
+		return false;
+	for (auto const& sourceName: _outputSelection.getMemberNames())
+		if (_outputSelection[sourceName].isObject())
+			for (auto const& contractName: _outputSelection[sourceName].getMemberNames())
+			{
+				Json::Value const& artifacts = _outputSelection[sourceName][contractName];
+				if (!contractName.empty() && artifacts.isArray() && requiresBinary(artifacts))
+					return true;
+			}
+	return false;
+}
+
 Json::Value formatLinkReferences(std::map<size_t, std::string> const& linkReferences)
 {
 	Json::Value ret(Json::objectValue);
@@ -227,7 +298,7 @@ Json::Value collectEVMObject(eth::LinkerObject const& _object, string const* _so
 
 }
 
-Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
+Json::Value StandardCompiler::compileInternal(Json::Value const& _input, OutputCallback const& _output)
 {
 	m_compilerStack.reset(false);
 
@@ -358,7 +429,35 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 					return formatFatalError("JSONError", "The \"runs\" setting must be an unsigned number.");
 				optimizeRuns = optimizerSettings["runs"].asUInt();
 			}
-			m_compilerStack.setOptimiserSettings(optimize, optimizeRuns);
+			bool optimizeControlFlow = false;
+			if (optimizerSettings.isMember("controlFlow"))
+			{
+				if (!optimizerSettings["controlFlow"].isBool())
+					return formatFatalError("JSONError", "The \"controlFlow\" setting must be a boolean.");
+				optimizeControlFlow = optimizerSettings["controlFlow"].asBool();
+			}
+			m_compilerStack.setOptimiserSettings(optimize, optimizeRuns, optimizeControlFlow);
+		}
+	}
+
+	if (settings.isMember("parallelism"))
+	{
+		if (!settings["parallelism"].isUInt())
+			return formatFatalError("JSONError", "The \"parallelism\" setting must be an unsigned number.");
+		m_compilerStack.setParallelism(settings["parallelism"].asUInt());
+	}
+
+	bool reportTiming = false;
+	if (settings.isMember("debug"))
+	{
+		Json::Value const& debugSettings = settings["debug"];
+		if (!debugSettings.isObject())
+			return formatFatalError("JSONError", "\"settings.debug\" must be an object.");
+		if (debugSettings.isMember("timing"))
+		{
+			if (!debugSettings["timing"].isBool())
+				return formatFatalError("JSONError", "The \"timing\" setting must be a boolean.");
+			reportTiming = debugSettings["timing"].asBool();
 		}
 	}
 
@@ -409,13 +508,22 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 	m_compilerStack.useMetadataLiteralSources(metadataSettings.get("useLiteralContent", Json::Value(false)).asBool());
 
 	Json::Value outputSelection = settings.get("outputSelection", Json::Value());
+	bool const binariesRequested = isBinaryRequested(outputSelection);
 	m_compilerStack.setRequestedContractNames(requestedContractNames(outputSelection));
 
 	auto scannerFromSourceName = [&](string const& _sourceName) -> solidity::Scanner const& { return m_compilerStack.scanner(_sourceName); };
 
+	TimingReport timingReport;
+	TimingReport::Activation timingActivation(reportTiming ? &timingReport : nullptr);
+
 	try
 	{
-		m_compilerStack.compile();
+		TimingScope timing("total");
+		/// Stop after analysis if no artifact needs code, e.g. if only the ABI or the AST are requested.
+		if (binariesRequested)
+			m_compilerStack.compile();
+		else
+			m_compilerStack.parseAndAnalyze();
 
 		for (auto const& error: m_compilerStack.errors())
 		{
@@ -509,17 +617,88 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 	bool const compilationSuccess = m_compilerStack.state() == CompilerStack::State::CompilationSuccessful;
 
 	/// Inconsistent state - stop here to receive error reports from users
-	if (!compilationSuccess && errors.empty())
+	if (!(binariesRequested ? compilationSuccess : analysisSuccess) && errors.empty())
 		return formatFatalError("InternalCompilerError", "No error reported, but compilation failed.");
 
-	Json::Value output = Json::objectValue;
+	// The parts of the output are passed on in the order of their keys, so that they can be
+	// written without constructing the whole output in memory.
+	map<string, vector<string>> contractsByFile;
+	for (string const& contractName: analysisSuccess ? m_compilerStack.contractNames() : vector<string>())
+	{
+		size_t colon = contractName.rfind(':');
+		solAssert(colon != string::npos, "");
+		contractsByFile[contractName.substr(0, colon)].push_back(contractName);
+	}
+
+	if (contractsByFile.empty())
+		_output({"contracts"}, Json::Value(Json::objectValue));
+	for (auto const& fileContracts: contractsByFile)
+		for (string const& contractName: fileContracts.second)
+		{
+			string const& file = fileContracts.first;
+			string name = contractName.substr(file.size() + 1);
+
+			// ABI, documentation and metadata
+			Json::Value contractData(Json::objectValue);
+			if (isArtifactRequested(outputSelection, file, name, "abi"))
+				contractData["abi"] = m_compilerStack.contractABI(contractName);
+			if (isArtifactRequested(outputSelection, file, name, "metadata"))
+				contractData["metadata"] = m_compilerStack.metadata(contractName);
+			if (isArtifactRequested(outputSelection, file, name, "userdoc"))
+				contractData["userdoc"] = m_compilerStack.natspecUser(contractName);
+			if (isArtifactRequested(outputSelection, file, name, "devdoc"))
+				contractData["devdoc"] = m_compilerStack.natspecDev(contractName);
+
+			// EVM
+			Json::Value evmData(Json::objectValue);
+			// @TODO: add ir
+			if (compilationSuccess && isArtifactRequested(outputSelection, file, name, "evm.assembly"))
+				evmData["assembly"] = m_compilerStack.assemblyString(contractName, createSourceList(_input));
+			if (compilationSuccess && isArtifactRequested(outputSelection, file, name, "evm.legacyAssembly"))
+				evmData["legacyAssembly"] = m_compilerStack.assemblyJSON(contractName, createSourceList(_input));
+			if (isArtifactRequested(outputSelection, file, name, "evm.methodIdentifiers"))
+				evmData["methodIdentifiers"] = m_compilerStack.methodIdentifiers(contractName);
+			if (compilationSuccess && isArtifactRequested(outputSelection, file, name, "evm.gasEstimates"))
+				evmData["gasEstimates"] = m_compilerStack.gasEstimates(contractName);
+
+			if (compilationSuccess && isArtifactRequested(
+				outputSelection,
+				file,
+				name,
+				{ "evm.bytecode", "evm.bytecode.object", "evm.bytecode.opcodes", "evm.bytecode.sourceMap", "evm.bytecode.linkReferences" }
+			))
+				evmData["bytecode"] = collectEVMObject(
+					m_compilerStack.object(contractName),
+					m_compilerStack.sourceMapping(contractName)
+				);
+
+			if (compilationSuccess && isArtifactRequested(
+				outputSelection,
+				file,
+				name,
+				{ "evm.deployedBytecode", "evm.deployedBytecode.object", "evm.deployedBytecode.opcodes", "evm.deployedBytecode.sourceMap", "evm.deployedBytecode.linkReferences" }
+			))
+				evmData["deployedBytecode"] = collectEVMObject(
+					m_compilerStack.runtimeObject(contractName),
+					m_compilerStack.runtimeSourceMapping(contractName)
+				);
+
+			contractData["evm"] = evmData;
+
+			_output({"contracts", file, name}, move(contractData));
+		}
+
+	if (reportTiming)
+		_output({"debug", "timing"}, timingReport.toJson());
 
 	if (errors.size() > 0)
-		output["errors"] = errors;
+		_output({"errors"}, move(errors));
 
-	output["sources"] = Json::objectValue;
+	vector<string> const sourceNames = analysisSuccess ? m_compilerStack.sourceNames() : vector<string>();
+	if (sourceNames.empty())
+		_output({"sources"}, Json::Value(Json::objectValue));
 	unsigned sourceIndex = 0;
-	for (string const& sourceName: analysisSuccess ? m_compilerStack.sourceNames() : vector<string>())
+	for (string const& sourceName: sourceNames)
 	{
 		Json::Value sourceResult = Json::objectValue;
 		sourceResult["id"] = sourceIndex++;
@@ -527,122 +706,97 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 			sourceResult["ast"] = ASTJsonConverter(false, m_compilerStack.sourceIndices()).toJson(m_compilerStack.ast(sourceName));
 		if (isArtifactRequested(outputSelection, sourceName, "", "legacyAST"))
 			sourceResult["legacyAST"] = ASTJsonConverter(true, m_compilerStack.sourceIndices()).toJson(m_compilerStack.ast(sourceName));
-		output["sources"][sourceName] = sourceResult;
+		_output({"sources", sourceName}, move(sourceResult));
 	}
 
-	Json::Value contractsOutput = Json::objectValue;
-	for (string const& contractName: compilationSuccess ? m_compilerStack.contractNames() : vector<string>())
-	{
-		size_t colon = contractName.rfind(':');
-		solAssert(colon != string::npos, "");
-		string file = contractName.substr(0, colon);
-		string name = contractName.substr(colon + 1);
-
-		// ABI, documentation and metadata
-		Json::Value contractData(Json::objectValue);
-		if (isArtifactRequested(outputSelection, file, name, "abi"))
-			contractData["abi"] = m_compilerStack.contractABI(contractName);
-		if (isArtifactRequested(outputSelection, file, name, "metadata"))
-			contractData["metadata"] = m_compilerStack.metadata(contractName);
-		if (isArtifactRequested(outputSelection, file, name, "userdoc"))
-			contractData["userdoc"] = m_compilerStack.natspecUser(contractName);
-		if (isArtifactRequested(outputSelection, file, name, "devdoc"))
-			contractData["devdoc"] = m_compilerStack.natspecDev(contractName);
-
-		// EVM
-		Json::Value evmData(Json::objectValue);
-		// @TODO: add ir
-		if (isArtifactRequested(outputSelection, file, name, "evm.assembly"))
-			evmData["assembly"] = m_compilerStack.assemblyString(contractName, createSourceList(_input));
-		if (isArtifactRequested(outputSelection, file, name, "evm.legacyAssembly"))
-			evmData["legacyAssembly"] = m_compilerStack.assemblyJSON(contractName, createSourceList(_input));
-		if (isArtifactRequested(outputSelection, file, name, "evm.methodIdentifiers"))
-			evmData["methodIdentifiers"] = m_compilerStack.methodIdentifiers(contractName);
-		if (isArtifactRequested(outputSelection, file, name, "evm.gasEstimates"))
-			evmData["gasEstimates"] = m_compilerStack.gasEstimates(contractName);
-
-		if (isArtifactRequested(
-			outputSelection,
-			file,
-			name,
-			{ "evm.bytecode", "evm.bytecode.object", "evm.bytecode.opcodes", "evm.bytecode.sourceMap", "evm.bytecode.linkReferences" }
-		))
-			evmData["bytecode"] = collectEVMObject(
-				m_compilerStack.object(contractName),
-				m_compilerStack.sourceMapping(contractName)
-			);
-
-		if (isArtifactRequested(
-			outputSelection,
-			file,
-			name,
-			{ "evm.deployedBytecode", "evm.deployedBytecode.object", "evm.deployedBytecode.opcodes", "evm.deployedBytecode.sourceMap", "evm.deployedBytecode.linkReferences" }
-		))
-			evmData["deployedBytecode"] = collectEVMObject(
-				m_compilerStack.runtimeObject(contractName),
-				m_compilerStack.runtimeSourceMapping(contractName)
-			);
-
-		contractData["evm"] = evmData;
-
-		if (!contractsOutput.isMember(file))
-			contractsOutput[file] = Json::objectValue;
-
-		contractsOutput[file][name] = contractData;
-	}
-	output["contracts"] = contractsOutput;
-
-	return output;
+	return Json::Value();
 }
 
 Json::Value StandardCompiler::compile(Json::Value const& _input) noexcept
 {
 	try
 	{
-		return compileInternal(_input);
-	}
-	catch (Json::LogicError const& _exception)
-	{
-		return formatFatalError("InternalCompilerError", string("JSON logic exception: ") + _exception.what());
-	}
-	catch (Json::RuntimeError const& _exception)
-	{
-		return formatFatalError("InternalCompilerError", string("JSON runtime exception: ") + _exception.what());
-	}
-	catch (Exception const& _exception)
-	{
-		return formatFatalError("InternalCompilerError", "Internal exception in StandardCompiler::compileInternal: " + boost::diagnostic_information(_exception));
+		Json::Value output(Json::objectValue);
+		Json::Value fatalError = compileInternal(_input, [&](vector<string> const& _path, Json::Value&& _value)
+		{
+			Json::Value* member = &output;
+			for (string const& key: _path)
+				member = &(*member)[key];
+			*member = move(_value);
+		});
+		return fatalError.isNull() ? output : fatalError;
 	}
 	catch (...)
 	{
-		return formatFatalError("InternalCompilerError", "Internal exception in StandardCompiler::compileInternal");
+		return formatCurrentException();
 	}
 }
 
 string StandardCompiler::compile(string const& _input) noexcept
+{
+	ostringstream output;
+	if (!compile(_input, output))
+		// The incomplete output is discarded, the error was produced after "errors" had been written.
+		return jsonCompactPrint(formatFatalError("InternalCompilerError", "Internal exception while generating the output."));
+	return output.str();
+}
+
+bool StandardCompiler::compile(string const& _input, ostream& _output) noexcept
 {
 	Json::Value input;
 	string errors;
 	try
 	{
 		if (!jsonParseStrict(_input, input, &errors))
-			return jsonCompactPrint(formatFatalError("JSONError", errors));
+		{
+			_output << jsonCompactPrint(formatFatalError("JSONError", errors));
+			return true;
+		}
 	}
 	catch (...)
 	{
-		return "{\"errors\":[{\"type\":\"JSONError\",\"component\":\"general\",\"severity\":\"error\",\"message\":\"Error parsing input JSON.\"}]}";
+		_output << "{\"errors\":[{\"type\":\"JSONError\",\"component\":\"general\",\"severity\":\"error\",\"message\":\"Error parsing input JSON.\"}]}";
+		return true;
 	}
 
-	// cout << "Input: " << input.toStyledString() << endl;
-	Json::Value output = compile(input);
-	// cout << "Output: " << output.toStyledString() << endl;
+	JsonStreamWriter writer(_output);
+	string lastSection;
+	Json::Value fatalError;
+	try
+	{
+		fatalError = compileInternal(input, [&](vector<string> const& _path, Json::Value&& _value)
+		{
+			lastSection = _path.front();
+			writer.write(_path, _value);
+		});
+	}
+	catch (...)
+	{
+		fatalError = formatCurrentException();
+	}
 
 	try
 	{
-		return jsonCompactPrint(output);
+		if (!fatalError.isNull() && !writer.started())
+		{
+			_output << jsonCompactPrint(fatalError);
+			return true;
+		}
+		if (!fatalError.isNull())
+		{
+			// An error while generating "sources" comes after "errors" has been written, so it
+			// cannot be reported anymore. The document is left incomplete instead.
+			if (lastSection >= "errors")
+				return false;
+			writer.write({"errors"}, fatalError["errors"]);
+		}
+		writer.finish();
 	}
 	catch (...)
 	{
-		return "{\"errors\":[{\"type\":\"JSONError\",\"component\":\"general\",\"severity\":\"error\",\"message\":\"Error writing output JSON.\"}]}";
+		if (writer.started())
+			return false;
+		_output << "{\"errors\":[{\"type\":\"JSONError\",\"component\":\"general\",\"severity\":\"error\",\"message\":\"Error writing output JSON.\"}]}";
 	}
+	return true;
 }
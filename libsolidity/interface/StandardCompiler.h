@@ -24,6 +24,9 @@
 
 #include <libsolidity/interface/CompilerStack.h>
 
+#include <functional>
+#include <ostream>
+
 namespace dev
 {
 
@@ -51,9 +54,28 @@ public:
 	/// Parses input as JSON and peforms the above processing steps, returning a serialized JSON
 	/// output. Parsing errors are returned as regular errors.
 	std::string compile(std::string const& _input) noexcept;
+	/// Same as above, but writes each part of the output to @a _output as soon as it is generated
+	/// instead of constructing the whole output in memory. The output is identical, but internal
+	/// errors that occur after "errors" has been written cannot be reported.
+	/// @returns false if such an error occurred, the output is then an incomplete JSON document.
+	bool compile(std::string const& _input, std::ostream& _output) noexcept;
+
+	/// Sets the cache used to avoid recompiling unchanged contracts.
+	/// See CompilerStack::setArtifactCache.
+	void setArtifactCache(std::shared_ptr<ArtifactCache> _cache) { m_compilerStack.setArtifactCache(std::move(_cache)); }
+
+	/// Enables reusing the syntax trees of unchanged sources between calls to compile.
+	/// See CompilerStack::useIncrementalParsing.
+	void useIncrementalParsing(bool _incrementalParsing) { m_compilerStack.useIncrementalParsing(_incrementalParsing); }
 
 private:
-	Json::Value compileInternal(Json::Value const& _input);
+	/// Receives a part of the output, given by its path from the root object.
+	using OutputCallback = std::function<void(std::vector<std::string> const& _path, Json::Value&& _value)>;
+
+	/// Performs the compilation and passes the parts of the output to @a _output in the order of
+	/// their keys, see JsonStreamWriter. @returns a fatal error output and does not call
+	/// @a _output if the input is invalid, a null value otherwise.
+	Json::Value compileInternal(Json::Value const& _input, OutputCallback const& _output);
 
 	CompilerStack m_compilerStack;
 	ReadCallback::Callback m_readFile;
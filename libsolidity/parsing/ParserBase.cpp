@@ -28,7 +28,7 @@ using namespace std;
 using namespace dev;
 using namespace dev::solidity;
 
-std::shared_ptr<string const> const& ParserBase::sourceName() const
+string const* ParserBase::sourceName() const
 {
 	return m_scanner->sourceName();
 }
@@ -38,7 +38,7 @@ class ParserBase
 public:
 	explicit ParserBase(ErrorReporter& errorReporter): m_errorReporter(errorReporter) {}
 
-	std::shared_ptr<std::string const> const& sourceName() const;
+	std::string const* sourceName() const;
 
 protected:
 	/// Utility class that creates an error and throws an exception if the
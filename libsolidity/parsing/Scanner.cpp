@@ -146,7 +146,7 @@ private:
 void Scanner::reset(CharStream const& _source, string const& _sourceName)
 {
 	m_source = _source;
-	m_sourceName = make_shared<string const>(_sourceName);
+	m_sourceName = internSourceName(_sourceName);
 	reset();
 }
 
@@ -886,35 +886,43 @@ char CharStream::rollback(size_t _amount)
 string CharStream::lineAtPosition(int _position) const
 {
 	// if _position points to \n, it returns the line before the \n
-	using size_type = string::size_type;
-	size_type searchStart = min<size_type>(m_source.size(), _position);
-	if (searchStart > 0)
-		searchStart--;
-	size_type lineStart = m_source.rfind('\n', searchStart);
-	if (lineStart == string::npos)
-		lineStart = 0;
-	else
-		lineStart++;
-	return m_source.substr(lineStart, min(m_source.find('\n', lineStart),
-										  m_source.size()) - lineStart);
+	vector<size_t> const& starts = lineStarts();
+	size_t line = lineIndex(_position);
+	size_t lineEnd = line + 1 < starts.size() ? starts[line + 1] - 1 : m_source.size();
+	return m_source.substr(starts[line], lineEnd - starts[line]);
 }
 
 tuple<int, int> CharStream::translatePositionToLineColumn(int _position) const
 {
-	using size_type = string::size_type;
-	size_type searchPosition = min<size_type>(m_source.size(), _position);
-	int lineNumber = count(m_source.begin(), m_source.begin() + searchPosition, '\n');
-	size_type lineStart;
-	if (searchPosition == 0)
-		lineStart = 0;
-	else
+	size_t searchPosition = min<size_t>(m_source.size(), _position);
+	size_t line = lineIndex(_position);
+	return tuple<int, int>(line, searchPosition - lineStarts()[line]);
+}
+
+vector<size_t> const& CharStream::lineStarts() const
+{
+	shared_ptr<vector<size_t> const> starts = atomic_load(&m_lineStarts);
+	if (!starts)
 	{
-		lineStart = m_source.rfind('\n', searchPosition - 1);
-		lineStart = lineStart == string::npos ? 0 : lineStart + 1;
+		auto newStarts = make_shared<vector<size_t>>(1, 0);
+		for (size_t i = 0; i < m_source.size(); ++i)
+			if (m_source[i] == '\n')
+				newStarts->push_back(i + 1);
+		starts = move(newStarts);
+		// Another thread might have been faster, use its index in that case.
+		shared_ptr<vector<size_t> const> expected;
+		if (!atomic_compare_exchange_strong(&m_lineStarts, &expected, starts))
+			starts = expected;
 	}
-	return tuple<int, int>(lineNumber, searchPosition - lineStart);
+	return *starts;
 }
 
+size_t CharStream::lineIndex(int _position) const
+{
+	size_t searchPosition = min<size_t>(m_source.size(), _position);
+	vector<size_t> const& starts = lineStarts();
+	return size_t(upper_bound(starts.begin(), starts.end(), searchPosition) - starts.begin()) - 1;
+}
 
 }
 }
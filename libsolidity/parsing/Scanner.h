@@ -57,6 +57,9 @@
 #include <libevmasm/SourceLocation.h>
 #include <libsolidity/parsing/Token.h>
 
+#include <memory>
+#include <vector>
+
 namespace dev
 {
 namespace solidity
@@ -83,16 +86,28 @@ public:
 	std::string const& source() const { return m_source; }
 
 	///@{
-	///@name Error printing helper functions
-	/// Functions that help pretty-printing parse errors
-	/// Do only use in error cases, they are quite expensive.
+	///@name Position translation helper functions
+	/// Functions that help pretty-printing errors and translating source locations.
+	/// They use an index of the line starts that is built on first use, so every call after
+	/// that is logarithmic in the number of lines.
 	std::string lineAtPosition(int _position) const;
+	/// @returns the zero-based line and column of @a _position.
 	std::tuple<int, int> translatePositionToLineColumn(int _position) const;
+	/// @returns the offsets at which the lines of the source start, i.e. zero and the offsets
+	/// following each newline character.
+	std::vector<size_t> const& lineStarts() const;
 	///@}
 
 private:
+	/// @returns the zero-based number of the line that contains @a _position, which is
+	/// clamped to the end of the source.
+	size_t lineIndex(int _position) const;
+
 	std::string m_source;
 	size_t m_position;
+	/// Index built by lineStarts(). It is shared between copies and never changes once set,
+	/// so that it can be built and used from multiple threads.
+	mutable std::shared_ptr<std::vector<size_t> const> m_lineStarts;
 };
 
 
@@ -154,14 +169,14 @@ public:
 	std::string const& peekLiteral() const { return m_nextToken.literal; }
 	///@}
 
-	std::shared_ptr<std::string const> const& sourceName() const { return m_sourceName; }
+	std::string const* sourceName() const { return m_sourceName; }
 
 	///@{
-	///@name Error printing helper functions
-	/// Functions that help pretty-printing parse errors
-	/// Do only use in error cases, they are quite expensive.
+	///@name Position translation helper functions
+	/// See CharStream.
 	std::string lineAtPosition(int _position) const { return m_source.lineAtPosition(_position); }
 	std::tuple<int, int> translatePositionToLineColumn(int _position) const { return m_source.translatePositionToLineColumn(_position); }
+	std::vector<size_t> const& lineStarts() const { return m_source.lineStarts(); }
 	///@}
 
 private:
@@ -232,7 +247,8 @@ private:
 	TokenDesc m_nextToken;     // desc for next token (one token look-ahead)
 
 	CharStream m_source;
-	std::shared_ptr<std::string const> m_sourceName;
+	/// Interned source name, see internSourceName.
+	std::string const* m_sourceName = nullptr;
 
 	/// one character look-ahead, equals 0 at end of input
 	char m_char;
@@ -34,6 +34,7 @@
 #include <libsolidity/interface/Exceptions.h>
 #include <libsolidity/interface/CompilerStack.h>
 #include <libsolidity/interface/StandardCompiler.h>
+#include <libsolidity/interface/ArtifactCache.h>
 #include <libsolidity/interface/SourceReferenceFormatter.h>
 #include <libsolidity/interface/GasEstimator.h>
 #include <libsolidity/interface/AssemblyStack.h>
@@ -45,6 +46,7 @@
 #include <libdevcore/CommonData.h>
 #include <libdevcore/CommonIO.h>
 #include <libdevcore/JSON.h>
+#include <libdevcore/TimingReport.h>
 
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/operations.hpp>
@@ -59,6 +61,7 @@
 #endif
 #include <string>
 #include <iostream>
+#include <sstream>
 #include <fstream>
 
 using namespace std;
@@ -80,6 +83,7 @@ static string const g_strAstJson = "ast-json";
 static string const g_strAstCompactJson = "ast-compact-json";
 static string const g_strBinary = "bin";
 static string const g_strBinaryRuntime = "bin-runtime";
+static string const g_strCacheDir = "cache-dir";
 static string const g_strCombinedJson = "combined-json";
 static string const g_strCompactJSON = "compact-format";
 static string const g_strContracts = "contracts";
@@ -91,6 +95,7 @@ static string const g_strGas = "gas";
 static string const g_strHelp = "help";
 static string const g_strInputFile = "input-file";
 static string const g_strInterface = "interface";
+static string const g_strJobs = "jobs";
 static string const g_strYul = "yul";
 static string const g_strLicense = "license";
 static string const g_strLibraries = "libraries";
@@ -103,8 +108,10 @@ static string const g_strNatspecUser = "userdoc";
 static string const g_strOpcodes = "opcodes";
 static string const g_strOptimize = "optimize";
 static string const g_strOptimizeRuns = "optimize-runs";
+static string const g_strOptimizeControlFlow = "optimize-control-flow";
 static string const g_strOutputDir = "output-dir";
 static string const g_strOverwrite = "overwrite";
+static string const g_strServer = "server";
 static string const g_strSignatureHashes = "hashes";
 static string const g_strSources = "sources";
 static string const g_strSourceList = "sourceList";
@@ -112,6 +119,7 @@ static string const g_strSrcMap = "srcmap";
 static string const g_strSrcMapRuntime = "srcmap-runtime";
 static string const g_strStandardJSON = "standard-json";
 static string const g_strStrictAssembly = "strict-assembly";
+static string const g_strTimeReport = "time-report";
 static string const g_strPrettyJson = "pretty-json";
 static string const g_strVersion = "version";
 static string const g_strIgnoreMissingFiles = "ignore-missing";
@@ -127,11 +135,13 @@ static string const g_argAstCompactJson = g_strAstCompactJson;
 static string const g_argAstJson = g_strAstJson;
 static string const g_argBinary = g_strBinary;
 static string const g_argBinaryRuntime = g_strBinaryRuntime;
+static string const g_argCacheDir = g_strCacheDir;
 static string const g_argCombinedJson = g_strCombinedJson;
 static string const g_argCompactJSON = g_strCompactJSON;
 static string const g_argGas = g_strGas;
 static string const g_argHelp = g_strHelp;
 static string const g_argInputFile = g_strInputFile;
+static string const g_argJobs = g_strJobs;
 static string const g_argYul = g_strYul;
 static string const g_argLibraries = g_strLibraries;
 static string const g_argLink = g_strLink;
@@ -143,10 +153,13 @@ static string const g_argNatspecUser = g_strNatspecUser;
 static string const g_argOpcodes = g_strOpcodes;
 static string const g_argOptimize = g_strOptimize;
 static string const g_argOptimizeRuns = g_strOptimizeRuns;
+static string const g_argOptimizeControlFlow = g_strOptimizeControlFlow;
 static string const g_argOutputDir = g_strOutputDir;
+static string const g_argServer = g_strServer;
 static string const g_argSignatureHashes = g_strSignatureHashes;
 static string const g_argStandardJSON = g_strStandardJSON;
 static string const g_argStrictAssembly = g_strStrictAssembly;
+static string const g_argTimeReport = g_strTimeReport;
 static string const g_argVersion = g_strVersion;
 static string const g_stdinFileName = g_stdinFileNameStr;
 static string const g_argIgnoreMissingFiles = g_strIgnoreMissingFiles;
@@ -564,6 +577,30 @@ Allowed options)",
 			"Set for how many contract runs to optimize."
 			"Lower values will optimize more for initial deployment cost, higher values will optimize more for high-frequency usage."
 		)
+		(
+			g_argOptimizeControlFlow.c_str(),
+			"Additionally optimize across basic blocks using the control flow graph, e.g. to reuse "
+			"storage values across conditional jumps. Only applies to contracts whose internal "
+			"functions are not stored by their constructor."
+		)
+		(
+			(g_argJobs + ",j").c_str(),
+			po::value<unsigned>()->value_name("n")->default_value(1),
+			"Number of threads used to generate and optimise the code of contracts and to estimate their gas costs. "
+			"The output does not depend on this setting."
+		)
+		(
+			g_argCacheDir.c_str(),
+			po::value<string>()->value_name("path"),
+			"Directory in which compiled contracts are cached. Contracts are only recompiled if one "
+			"of their sources or a setting that influences their bytecode changes."
+		)
+		(
+			g_argTimeReport.c_str(),
+			"Print the wall time and number of heap allocations of every compilation phase per source and "
+			"contract, the peak memory usage of the process so far at its end, and how often each optimiser "
+			"pass changed the code, to standard error."
+		)
 		(g_argPrettyJson.c_str(), "Output JSON in pretty format. Currently it only works with the combined JSON output.")
 		(
 			g_argLibraries.c_str(),
@@ -586,9 +623,15 @@ Allowed options)",
 		(g_argGas.c_str(), "Print an estimate of the maximal gas usage for each function.")
 		(
 			g_argStandardJSON.c_str(),
-			"Switch to Standard JSON input / output mode, ignoring all options. "
+			"Switch to Standard JSON input / output mode, ignoring all options except --cache-dir. "
 			"It reads from standard input and provides the result on the standard output."
 		)
+		(
+			g_argServer.c_str(),
+			"Switch to server mode, ignoring all options except --cache-dir. Reads one Standard JSON input per line "
+			"from standard input and writes each result as a single line to standard output. "
+			"Unchanged sources are not parsed again and unchanged contracts are not compiled again."
+		)
 		(
 			g_argAssemble.c_str(),
 			"Switch to assembly mode, ignoring all options except --machine and assumes input is assembly."
@@ -755,10 +798,18 @@ bool CommandLineInterface::processInput()
 	{
 		string input = dev::readStandardInput();
 		StandardCompiler compiler(fileReader);
-		cout << compiler.compile(input) << endl;
-		return true;
+		if (m_args.count(g_argCacheDir))
+			compiler.setArtifactCache(make_shared<ArtifactCache>(m_args[g_argCacheDir].as<string>()));
+		bool const complete = compiler.compile(input, cout);
+		cout << endl;
+		if (!complete)
+			cerr << "Internal error while generating the output, the output is incomplete." << endl;
+		return complete;
 	}
 
+	if (m_args.count(g_argServer))
+		return serve(fileReader);
+
 	if (!readInputFilesAndConfigureRemappings())
 		return false;
 
@@ -830,9 +881,18 @@ bool CommandLineInterface::processInput()
 		// TODO: Perhaps we should not compile unless requested
 		bool optimize = m_args.count(g_argOptimize) > 0;
 		unsigned runs = m_args[g_argOptimizeRuns].as<unsigned>();
-		m_compiler->setOptimiserSettings(optimize, runs);
-
-		bool successful = m_compiler->compile();
+		m_compiler->setOptimiserSettings(optimize, runs, m_args.count(g_argOptimizeControlFlow) > 0);
+		m_compiler->setParallelism(m_args[g_argJobs].as<unsigned>());
+		if (m_args.count(g_argCacheDir))
+			m_compiler->setArtifactCache(make_shared<ArtifactCache>(m_args[g_argCacheDir].as<string>()));
+
+		TimingReport timingReport;
+		TimingReport::Activation timingActivation(m_args.count(g_argTimeReport) ? &timingReport : nullptr);
+		bool successful = false;
+		{
+			TimingScope timing("total");
+			successful = m_compiler->compile();
+		}
 
 		for (auto const& error: m_compiler->errors())
 			formatter.printExceptionInformation(
@@ -840,6 +900,9 @@ bool CommandLineInterface::processInput()
 				(error->type() == Error::Type::Warning) ? "Warning" : "Error"
 			);
 
+		if (m_args.count(g_argTimeReport))
+			cerr << timingReport.toString();
+
 		if (!successful)
 			return false;
 	}
@@ -888,18 +951,18 @@ void CommandLineInterface::handleCombinedJSON()
 	if (!m_args.count(g_argCombinedJson))
 		return;
 
-	Json::Value output(Json::objectValue);
-
-	output[g_strVersion] = ::dev::solidity::VersionString;
 	set<string> requests;
 	boost::split(requests, m_args[g_argCombinedJson].as<string>(), boost::is_any_of(","));
-	vector<string> contracts = m_compiler->contractNames();
 
-	if (!contracts.empty())
-		output[g_strContracts] = Json::Value(Json::objectValue);
-	for (string const& contractName: contracts)
+	// The output is written member by member in the order of the keys, so that the syntax trees
+	// of all sources are never in memory at the same time.
+	ostringstream buffer;
+	bool const toFile = m_args.count(g_argOutputDir);
+	JsonStreamWriter output(toFile ? buffer : cout, m_args.count(g_argPrettyJson));
+
+	for (string const& contractName: m_compiler->contractNames())
 	{
-		Json::Value& contractData = output[g_strContracts][contractName] = Json::objectValue;
+		Json::Value contractData(Json::objectValue);
 		if (requests.count(g_strAbi))
 			contractData[g_strAbi] = dev::jsonCompactPrint(m_compiler->contractABI(contractName));
 		if (requests.count("metadata"))
@@ -928,36 +991,38 @@ void CommandLineInterface::handleCombinedJSON()
 			contractData[g_strNatspecDev] = dev::jsonCompactPrint(m_compiler->natspecDev(contractName));
 		if (requests.count(g_strNatspecUser))
 			contractData[g_strNatspecUser] = dev::jsonCompactPrint(m_compiler->natspecUser(contractName));
+		output.write({g_strContracts, contractName}, contractData);
 	}
 
 	bool needsSourceList = requests.count(g_strAst) || requests.count(g_strSrcMap) || requests.count(g_strSrcMapRuntime);
 	if (needsSourceList)
 	{
 		// Indices into this array are used to abbreviate source names in source locations.
-		output[g_strSourceList] = Json::Value(Json::arrayValue);
-
+		Json::Value sourceList(Json::arrayValue);
 		for (auto const& source: m_compiler->sourceNames())
-			output[g_strSourceList].append(source);
+			sourceList.append(source);
+		output.write({g_strSourceList}, sourceList);
 	}
 
 	if (requests.count(g_strAst))
 	{
 		bool legacyFormat = !requests.count(g_strCompactJSON);
-		output[g_strSources] = Json::Value(Json::objectValue);
+		if (m_sourceCodes.empty())
+			output.write({g_strSources}, Json::Value(Json::objectValue));
 		for (auto const& sourceCode: m_sourceCodes)
 		{
 			ASTJsonConverter converter(legacyFormat, m_compiler->sourceIndices());
-			output[g_strSources][sourceCode.first] = Json::Value(Json::objectValue);
-			output[g_strSources][sourceCode.first]["AST"] = converter.toJson(m_compiler->ast(sourceCode.first));
+			output.write({g_strSources, sourceCode.first, "AST"}, converter.toJson(m_compiler->ast(sourceCode.first)));
 		}
 	}
 
-	string json = m_args.count(g_argPrettyJson) ? dev::jsonPrettyPrint(output) : dev::jsonCompactPrint(output);
+	output.write({g_strVersion}, Json::Value(::dev::solidity::VersionString));
+	output.finish();
 
-	if (m_args.count(g_argOutputDir))
-		createJson("combined", json);
+	if (toFile)
+		createJson("combined", buffer.str());
 	else
-		cout << json << endl;
+		cout << endl;
 }
 
 void CommandLineInterface::handleAst(string const& _argStr)
@@ -1037,7 +1102,7 @@ void CommandLineInterface::handleAst(string const& _argStr)
 
 bool CommandLineInterface::actOnInput()
 {
-	if (m_args.count(g_argStandardJSON) || m_onlyAssemble)
+	if (m_args.count(g_argStandardJSON) || m_args.count(g_argServer) || m_onlyAssemble)
 		// Already done in "processInput" phase.
 		return true;
 	else if (m_onlyLink)
@@ -1047,6 +1112,28 @@ bool CommandLineInterface::actOnInput()
 	return !m_error;
 }
 
+bool CommandLineInterface::serve(ReadCallback::Callback const& _readFile)
+{
+	StandardCompiler compiler(_readFile);
+	compiler.useIncrementalParsing(true);
+	compiler.setArtifactCache(make_shared<ArtifactCache>(
+		m_args.count(g_argCacheDir) ? m_args[g_argCacheDir].as<string>() : string()
+	));
+
+	string input;
+	while (getline(cin, input))
+	{
+		if (boost::algorithm::trim_copy(input).empty())
+			continue;
+		bool const complete = compiler.compile(input, cout);
+		// endl flushes the output, so that the client can read the result immediately.
+		cout << endl;
+		if (!complete)
+			cerr << "Internal error while generating the output, the output is incomplete." << endl;
+	}
+	return true;
+}
+
 bool CommandLineInterface::link()
 {
 	// Map from how the libraries will be named inside the bytecode to their addresses.
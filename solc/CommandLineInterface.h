@@ -57,6 +57,10 @@ private:
 
 	bool assemble(AssemblyStack::Language _language, AssemblyStack::Machine _targetMachine);
 
+	/// Compiles Standard JSON inputs read line by line from standard input until it is closed.
+	/// Parsed sources and compiled contracts are kept between the inputs.
+	bool serve(ReadCallback::Callback const& _readFile);
+
 	void outputCompilationResults();
 
 	void handleCombinedJSON();
@@ -21,12 +21,42 @@
  */
 
 #include "CommandLineInterface.h"
+#include <libdevcore/TimingReport.h>
 #include <clocale>
+#include <cstdlib>
 #include <iostream>
+#include <new>
 #include <boost/exception/all.hpp>
 
 using namespace std;
 
+/*
+Count the heap allocations of each thread, so that they can be reported by --time-report
+and the Standard JSON setting "debug.timing". Apart from a thread-local increment, these
+behave like the default implementations: If the allocation fails, the installed new_handler
+is called and the allocation is retried until the handler is unset.
+*/
+void* operator new(size_t _size)
+{
+	++dev::allocationCounter();
+	if (_size == 0)
+		_size = 1;
+	while (true)
+	{
+		if (void* memory = malloc(_size))
+			return memory;
+		new_handler handler = get_new_handler();
+		if (!handler)
+			throw bad_alloc();
+		handler();
+	}
+}
+
+void operator delete(void* _memory) noexcept
+{
+	free(_memory);
+}
+
 /*
 The equivalent of setlocale(LC_ALL, "C") is called before any user code is run.
 If the user has an invalid environment setting then it is possible for the call
@@ -276,6 +276,26 @@ SOLTMPDIR=$(mktemp -d)
     fi
 )
 
+printTask "Testing server mode..."
+(
+    set -e
+    input='{"language": "Solidity", "sources": {"a.sol": {"content": "contract C { function f() public {} }"}}, "settings": {"outputSelection": {"*": {"*": ["evm.bytecode.object"]}}}}'
+    changedInput="${input/f()/g()}"
+    expectation=$(echo "$input" | "$SOLC" --standard-json)
+    output=$(printf '%s\n\n%s\n%s\n' "$input" "$input" "$changedInput" | "$SOLC" --server)
+
+    # One line per request, identical requests give the same result as --standard-json.
+    if [[ $(echo "$output" | wc -l) != 3 || \
+        "$(echo "$output" | sed -n 1p)" != "$expectation" || \
+        "$(echo "$output" | sed -n 2p)" != "$expectation" || \
+        "$(echo "$output" | sed -n 3p)" == "$expectation" ]]
+    then
+        printError "Unexpected output of server mode:"
+        echo "$output"
+        exit 1
+    fi
+)
+
 printTask "Testing soljson via the fuzzer..."
 SOLTMPDIR=$(mktemp -d)
 (
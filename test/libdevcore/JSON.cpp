@@ -20,9 +20,12 @@
  */
 
 #include <libdevcore/JSON.h>
+#include <libdevcore/Exceptions.h>
 
 #include <test/Options.h>
 
+#include <sstream>
+
 using namespace std;
 
 namespace dev
@@ -69,6 +72,55 @@ BOOST_AUTO_TEST_CASE(json_compact_print)
 	BOOST_CHECK("{\"1\":1,\"2\":\"2\",\"3\":{\"3.1\":\"3.1\",\"3.2\":2}}" == jsonCompactPrint(json));
 }
 
+BOOST_AUTO_TEST_CASE(json_stream_writer)
+{
+	Json::Value longArray(Json::arrayValue);
+	for (int i = 0; i < 40; ++i)
+		longArray.append(i);
+	Json::Value nested;
+	nested["a"] = Json::arrayValue;
+	nested["b"] = Json::objectValue;
+	nested["c"]["d"] = "line\nbreak";
+	nested["c"]["e"] = longArray;
+	nested["f"] = Json::arrayValue;
+	nested["f"].append(1);
+	nested["f"].append(nested["c"]);
+
+	Json::Value json;
+	json["1"] = 1;
+	json["2"]["x"]["y"] = nested;
+	json["2"]["x"]["z"] = "z";
+	json["2"]["y"] = longArray;
+	json["3"]["a"] = nested["f"];
+	json["3:b"] = Json::objectValue;
+	json["4"] = nested;
+
+	for (bool pretty: {false, true})
+	{
+		ostringstream stream;
+		JsonStreamWriter writer(stream, pretty);
+		writer.write({"1"}, json["1"]);
+		writer.write({"2", "x", "y"}, json["2"]["x"]["y"]);
+		writer.write({"2", "x", "z"}, json["2"]["x"]["z"]);
+		writer.write({"2", "y"}, json["2"]["y"]);
+		writer.write({"3", "a"}, json["3"]["a"]);
+		writer.write({"3:b"}, json["3:b"]);
+		writer.write({"4"}, json["4"]);
+		writer.finish();
+		BOOST_CHECK_EQUAL(stream.str(), pretty ? jsonPrettyPrint(json) : jsonCompactPrint(json));
+	}
+
+	ostringstream stream;
+	JsonStreamWriter writer(stream);
+	writer.finish();
+	BOOST_CHECK_EQUAL(stream.str(), "{}");
+
+	JsonStreamWriter unordered(stream);
+	unordered.write({"b", "x"}, 1);
+	BOOST_CHECK_THROW(unordered.write({"a"}, 1), JSONWriterError);
+	BOOST_CHECK_THROW(unordered.write({"b", "x"}, 1), JSONWriterError);
+}
+
 BOOST_AUTO_TEST_CASE(parse_json_not_strict)
 {
 	Json::Value json;
@@ -0,0 +1,83 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for LRUCache.
+ */
+
+#include <libdevcore/LRUCache.h>
+
+#include <test/Options.h>
+
+#include <string>
+
+using namespace std;
+
+namespace dev
+{
+namespace test
+{
+
+BOOST_AUTO_TEST_SUITE(LRUCacheTest)
+
+BOOST_AUTO_TEST_CASE(lookup_and_store)
+{
+	LRUCache<string, int> cache(4);
+	BOOST_CHECK(!cache.lookup("a"));
+	cache.store("a", 1);
+	cache.store("b", 2);
+	BOOST_CHECK_EQUAL(*cache.lookup("a"), 1);
+	BOOST_CHECK_EQUAL(*cache.lookup("b"), 2);
+	cache.store("a", 3);
+	BOOST_CHECK_EQUAL(*cache.lookup("a"), 3);
+	BOOST_CHECK_EQUAL(cache.size(), 2);
+	cache.clear();
+	BOOST_CHECK(!cache.lookup("a"));
+	BOOST_CHECK_EQUAL(cache.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(evicts_least_recently_used)
+{
+	LRUCache<int, int> cache(3);
+	cache.store(1, 1);
+	cache.store(2, 2);
+	cache.store(3, 3);
+	// Looking up 1 makes 2 the least recently used entry.
+	BOOST_CHECK(cache.lookup(1));
+	cache.store(4, 4);
+	BOOST_CHECK_EQUAL(cache.size(), 3);
+	BOOST_CHECK(!cache.lookup(2));
+	BOOST_CHECK(cache.lookup(1));
+	BOOST_CHECK(cache.lookup(3));
+	BOOST_CHECK(cache.lookup(4));
+	// Storing to an existing key does not evict anything.
+	cache.store(3, 5);
+	BOOST_CHECK_EQUAL(cache.size(), 3);
+	BOOST_CHECK_EQUAL(*cache.lookup(3), 5);
+}
+
+BOOST_AUTO_TEST_CASE(zero_capacity)
+{
+	LRUCache<int, int> cache(0);
+	cache.store(1, 1);
+	BOOST_CHECK(!cache.lookup(1));
+	BOOST_CHECK_EQUAL(cache.size(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
@@ -54,10 +54,10 @@ BOOST_AUTO_TEST_SUITE(Assembler)
 BOOST_AUTO_TEST_CASE(all_assembly_items)
 {
 	Assembly _assembly;
-	_assembly.setSourceLocation(SourceLocation(1, 3, make_shared<string>("root.asm")));
+	_assembly.setSourceLocation(SourceLocation(1, 3, internSourceName("root.asm")));
 
 	Assembly _subAsm;
-	_subAsm.setSourceLocation(SourceLocation(6, 8, make_shared<string>("sub.asm")));
+	_subAsm.setSourceLocation(SourceLocation(6, 8, internSourceName("sub.asm")));
 	_subAsm.append(Instruction::INVALID);
 	shared_ptr<Assembly> _subAsmPtr = make_shared<Assembly>(_subAsm);
 
@@ -145,6 +145,34 @@ BOOST_AUTO_TEST_CASE(all_assembly_items)
 	);
 }
 
+BOOST_AUTO_TEST_CASE(item_data)
+{
+	u256 small = u256(1) << 63;
+	u256 large = u256(1) << 64;
+	u256 larger = u256(-1);
+	BOOST_CHECK_EQUAL(AssemblyItem(small).data(), small);
+	BOOST_CHECK_EQUAL(AssemblyItem(large).data(), large);
+	BOOST_CHECK_EQUAL(AssemblyItem(larger).data(), larger);
+
+	BOOST_CHECK(AssemblyItem(large) == AssemblyItem(large));
+	BOOST_CHECK(AssemblyItem(small) != AssemblyItem(large));
+	BOOST_CHECK(AssemblyItem(small) < AssemblyItem(large));
+	BOOST_CHECK(!(AssemblyItem(large) < AssemblyItem(small)));
+	BOOST_CHECK(AssemblyItem(large) < AssemblyItem(larger));
+	BOOST_CHECK(AssemblyItem(u256(1)) < AssemblyItem(small));
+
+	AssemblyItem item(large);
+	AssemblyItem copy = item;
+	item.setData(small);
+	BOOST_CHECK_EQUAL(item.data(), small);
+	BOOST_CHECK_EQUAL(copy.data(), large);
+	item.setData(larger);
+	BOOST_CHECK_EQUAL(item.data(), larger);
+
+	AssemblyItem tag = AssemblyItem(PushTag, 5).toSubAssemblyTag(3);
+	BOOST_CHECK(tag.splitForeignPushTag() == make_pair(size_t(3), size_t(5)));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
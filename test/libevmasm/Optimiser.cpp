@@ -28,6 +28,9 @@
 #include <libevmasm/ControlFlowGraph.h>
 #include <libevmasm/BlockDeduplicator.h>
 #include <libevmasm/Assembly.h>
+#include <libevmasm/ConstantOptimiser.h>
+
+#include <libdevcore/TimingReport.h>
 
 #include <boost/test/unit_test.hpp>
 
@@ -52,7 +55,7 @@ namespace
 		// add dummy locations to each item so that we can check that they are not deleted
 		AssemblyItems input = _input;
 		for (AssemblyItem& item: input)
-			item.setLocation(SourceLocation(1, 3, make_shared<string>("")));
+			item.setLocation(SourceLocation(1, 3, internSourceName("")));
 		return input;
 	}
 
@@ -111,6 +114,34 @@ namespace
 		AssemblyItems output = CFG(_input);
 		BOOST_CHECK_EQUAL_COLLECTIONS(_expectation.begin(), _expectation.end(), output.begin(), output.end());
 	}
+
+	/// Optimises @a _sub as the sub-assembly of an otherwise empty assembly, which refers to
+	/// @a _referencedTag of @a _sub if given, and @returns the optimised items of @a _sub.
+	AssemblyItems optimiseSubAssembly(
+		AssemblyPointer const& _sub,
+		Assembly::OptimiserSettings _settings,
+		AssemblyItem const* _referencedTag = nullptr
+	)
+	{
+		Assembly main;
+		size_t subId = size_t(main.appendSubroutine(_sub).data());
+		if (_referencedTag)
+			main.append(_referencedTag->toSubAssemblyTag(subId));
+		_settings.evmVersion = dev::test::Options::get().evmVersion();
+		main.optimise(_settings);
+		return _sub->items();
+	}
+
+	/// @returns the value of the counter @a _name of @a _phase in @a _report or zero if it was not counted.
+	size_t counter(TimingReport const& _report, string const& _phase, string const& _name)
+	{
+		// entries() returns a copy, which has to outlive the lookup.
+		auto const entries = _report.entries();
+		auto entry = entries.find(make_pair(_phase, string()));
+		if (entry == entries.end() || !entry->second.counters.count(_name))
+			return 0;
+		return entry->second.counters.at(_name);
+	}
 }
 
 BOOST_AUTO_TEST_SUITE(Optimiser)
@@ -749,6 +780,8 @@ BOOST_AUTO_TEST_CASE(block_deduplicator)
 		if (item.type() == PushTag)
 			pushTags.insert(item.data());
 	BOOST_CHECK_EQUAL(pushTags.size(), 2);
+	// The block at tag 2 is removed: JUMPDEST, PUSH1 6, SWAP3, JUMP
+	BOOST_CHECK_EQUAL(dedup.bytesSaved(), 5);
 }
 
 BOOST_AUTO_TEST_CASE(block_deduplicator_loops)
@@ -852,9 +885,32 @@ BOOST_AUTO_TEST_CASE(peephole_pop_calldatasize)
 		Instruction::POP
 	};
 	PeepholeOptimiser peepOpt(items);
-	for (size_t i = 0; i < 3; i++)
-		BOOST_CHECK(peepOpt.optimise());
+	BOOST_CHECK(peepOpt.optimise());
 	BOOST_CHECK(items.empty());
+	BOOST_CHECK(!peepOpt.optimise());
+}
+
+BOOST_AUTO_TEST_CASE(peephole_single_pass_cascade)
+{
+	// Every rewrite enables another one before it, which has to be found in the same pass.
+	AssemblyItems items{
+		u256(1),
+		u256(2),
+		u256(3),
+		Instruction::ADDMOD,
+		Instruction::POP,
+		Instruction::CALLVALUE
+	};
+	PeepholeOptimiser peepOpt(items);
+	BOOST_CHECK(peepOpt.optimise());
+	AssemblyItems expectation{
+		Instruction::CALLVALUE
+	};
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		items.begin(), items.end(),
+		expectation.begin(), expectation.end()
+	);
+	BOOST_CHECK(!peepOpt.optimise());
 }
 
 BOOST_AUTO_TEST_CASE(peephole_commutative_swap1)
@@ -1074,6 +1130,275 @@ BOOST_AUTO_TEST_CASE(jumpdest_removal_subassemblies)
 	);
 }
 
+BOOST_AUTO_TEST_CASE(parallel_subassembly_optimisation)
+{
+	// Optimising the sub-assemblies on multiple threads has to yield
+	// exactly the same result as optimising them serially.
+	auto createAssembly = []()
+	{
+		auto main = make_shared<Assembly>();
+		for (unsigned i = 0; i < 5; ++i)
+		{
+			AssemblyPointer sub = make_shared<Assembly>();
+			auto t1 = sub->newTag();
+			sub->append(t1);
+			sub->append(u256(i));
+			sub->append(Instruction::JUMP);
+			auto t2 = sub->newTag();
+			sub->append(t2); // Identical to T1, will be unified
+			sub->append(u256(i));
+			sub->append(Instruction::JUMP);
+			sub->append(sub->newTag()); // This will be removed
+			sub->append(u256(i));
+			sub->append(u256(3));
+			sub->append(Instruction::ADD);
+			sub->append(Instruction::POP);
+			size_t subId = size_t(main->appendSubroutine(sub).data());
+			main->append(t2.toSubAssemblyTag(subId));
+		}
+		return main;
+	};
+
+	AssemblyPointer serial = createAssembly();
+	serial->optimise(true, dev::test::Options::get().evmVersion(), true, 200, 1);
+	AssemblyPointer parallel = createAssembly();
+	parallel->optimise(true, dev::test::Options::get().evmVersion(), true, 200, 4);
+
+	BOOST_CHECK_EQUAL(serial->assemblyString(), parallel->assemblyString());
+	BOOST_CHECK(serial->assemble().bytecode == parallel->assemble().bytecode);
+}
+
+BOOST_AUTO_TEST_CASE(constant_optimiser_cached_decisions)
+{
+	// The decisions of the constant optimiser are shared between assemblies,
+	// but the data of the code copy method still has to end up in each of them.
+	auto optimise = [](u256 const& _value, size_t _multiplicity, size_t& _cacheHits)
+	{
+		TimingReport report;
+		TimingReport::Activation activation(&report);
+		Assembly assembly;
+		AssemblyItems items(_multiplicity, AssemblyItem(_value));
+		{
+			TimingScope timing("constants");
+			ConstantOptimisationMethod::optimiseConstants(
+				true,
+				200,
+				dev::test::Options::get().evmVersion(),
+				assembly,
+				items
+			);
+		}
+		_cacheHits = counter(report, "constants", "cacheHits");
+		for (auto const& item: items)
+			assembly.append(item);
+		return assembly.assemble().bytecode;
+	};
+	auto contains = [](bytes const& _code, u256 const& _value)
+	{
+		bytes value = toBigEndian(_value);
+		return search(_code.begin(), _code.end(), value.begin(), value.end()) != _code.end();
+	};
+
+	size_t cacheHits = 0;
+	u256 copied("0x1234567890abcdef1234567890abcdef1234567890abcdef1234567890abcdef");
+	bytes first = optimise(copied, 20, cacheHits);
+	BOOST_CHECK_EQUAL(cacheHits, 0);
+	BOOST_CHECK(first.size() < 20 * 33);
+	BOOST_CHECK(contains(first, copied));
+	bytes second = optimise(copied, 20, cacheHits);
+	BOOST_CHECK_EQUAL(cacheHits, 1);
+	BOOST_CHECK(first == second);
+	BOOST_CHECK(contains(second, copied));
+
+	u256 computed = ~u256(0x1357);
+	bytes firstComputed = optimise(computed, 10, cacheHits);
+	BOOST_CHECK_EQUAL(cacheHits, 0);
+	BOOST_CHECK(firstComputed.size() < 10 * 33);
+	BOOST_CHECK(firstComputed == optimise(computed, 10, cacheHits));
+	BOOST_CHECK_EQUAL(cacheHits, 1);
+}
+
+BOOST_AUTO_TEST_CASE(control_flow_optimiser)
+{
+	// The loop cannot be entered and is removed. The block that is only reached by
+	// the unconditional jump is moved behind it.
+	auto optimise = [](bool _controlFlow, bool _loopReferencedFromOutside)
+	{
+		AssemblyPointer sub = make_shared<Assembly>();
+		AssemblyItem loop = sub->newTag();
+		AssemblyItem target = sub->newTag();
+		sub->append(target.pushTag());
+		sub->append(Instruction::JUMP);
+		sub->append(loop);
+		sub->append(u256(1));
+		sub->append(Instruction::SLOAD);
+		sub->append(u256(2));
+		sub->append(Instruction::SSTORE);
+		sub->append(loop.pushTag());
+		sub->append(Instruction::JUMP);
+		sub->append(target);
+		sub->append(u256(0));
+		sub->append(Instruction::SLOAD);
+		sub->append(u256(1));
+		sub->append(Instruction::SSTORE);
+		sub->append(Instruction::STOP);
+
+		Assembly::OptimiserSettings settings;
+		settings.runJumpdestRemover = true;
+		settings.runPeephole = true;
+		settings.runDeduplicate = true;
+		settings.runCSE = true;
+		settings.runControlFlowOptimiser = _controlFlow;
+		AssemblyItems items = optimiseSubAssembly(sub, settings, _loopReferencedFromOutside ? &loop : nullptr);
+		return to_string(count(items.begin(), items.end(), AssemblyItem(Instruction::JUMP))) + " jumps, " +
+			to_string(count(items.begin(), items.end(), AssemblyItem(Instruction::SLOAD))) + " sloads";
+	};
+
+	BOOST_CHECK_EQUAL(optimise(false, false), "2 jumps, 2 sloads");
+	BOOST_CHECK_EQUAL(optimise(true, false), "0 jumps, 1 sloads");
+	// The loop might be entered from the outer assembly, so the control flow
+	// graph is not complete.
+	BOOST_CHECK_EQUAL(optimise(true, true), "2 jumps, 2 sloads");
+}
+
+BOOST_AUTO_TEST_CASE(control_flow_optimiser_forwards_knowledge)
+{
+	// The storage slot loaded before the conditional jump is reused in the block that follows it
+	// and in its target, which can only be reached by this jump.
+	auto optimise = [](bool _controlFlow, bool _targetReferencedFromOutside)
+	{
+		AssemblyPointer sub = make_shared<Assembly>();
+		AssemblyItem target = sub->newTag();
+		sub->append(u256(0));
+		sub->append(Instruction::SLOAD);
+		sub->append(Instruction::DUP1);
+		sub->append(target.pushTag());
+		sub->append(Instruction::JUMPI);
+		sub->append(u256(0));
+		sub->append(Instruction::SLOAD);
+		sub->append(u256(7));
+		sub->append(Instruction::ADD);
+		sub->append(u256(1));
+		sub->append(Instruction::SSTORE);
+		sub->append(Instruction::STOP);
+		sub->append(target);
+		sub->append(u256(0));
+		sub->append(Instruction::SLOAD);
+		sub->append(u256(9));
+		sub->append(Instruction::ADD);
+		sub->append(u256(2));
+		sub->append(Instruction::SSTORE);
+		sub->append(Instruction::STOP);
+
+		Assembly::OptimiserSettings settings;
+		settings.runControlFlowOptimiser = _controlFlow;
+		AssemblyItems items = optimiseSubAssembly(sub, settings, _targetReferencedFromOutside ? &target : nullptr);
+		return count(items.begin(), items.end(), AssemblyItem(Instruction::SLOAD));
+	};
+
+	BOOST_CHECK_EQUAL(optimise(false, false), 3);
+	BOOST_CHECK_EQUAL(optimise(true, false), 1);
+	// The control flow graph is not complete if the target is referenced from outside.
+	BOOST_CHECK_EQUAL(optimise(true, true), 3);
+}
+
+BOOST_AUTO_TEST_CASE(cse_extended_basic_blocks)
+{
+	// The storage slot loaded before the conditional jump is reused in both successors.
+	auto optimise = [](bool _extendedBlocks, bool _targetReferencedFromOutside)
+	{
+		AssemblyPointer sub = make_shared<Assembly>();
+		AssemblyItem target = sub->newTag();
+		sub->append(u256(0));
+		sub->append(Instruction::SLOAD);
+		sub->append(Instruction::DUP1);
+		sub->append(target.pushTag());
+		sub->append(Instruction::JUMPI);
+		sub->append(u256(0));
+		sub->append(Instruction::SLOAD);
+		sub->append(u256(7));
+		sub->append(Instruction::ADD);
+		sub->append(u256(1));
+		sub->append(Instruction::SSTORE);
+		sub->append(Instruction::STOP);
+		sub->append(target);
+		sub->append(u256(0));
+		sub->append(Instruction::SLOAD);
+		sub->append(u256(9));
+		sub->append(Instruction::ADD);
+		sub->append(u256(2));
+		sub->append(Instruction::SSTORE);
+		sub->append(Instruction::STOP);
+
+		Assembly::OptimiserSettings settings;
+		settings.runCSE = true;
+		settings.runExtendedBasicBlockCSE = _extendedBlocks;
+		AssemblyItems items = optimiseSubAssembly(sub, settings, _targetReferencedFromOutside ? &target : nullptr);
+		return count(items.begin(), items.end(), AssemblyItem(Instruction::SLOAD));
+	};
+
+	BOOST_CHECK_EQUAL(optimise(false, false), 3);
+	BOOST_CHECK_EQUAL(optimise(true, false), 1);
+	// The target might also be reached from the outer assembly.
+	BOOST_CHECK_EQUAL(optimise(true, true), 2);
+}
+
+BOOST_AUTO_TEST_CASE(cse_skips_stable_blocks)
+{
+	// The first round of the common subexpression eliminator removes the only reference to the
+	// second block, which is then removed in the second round, before the eliminator runs again.
+	auto optimise = [](Instruction _unreachableValue, size_t& _skippedBlocks)
+	{
+		TimingReport report;
+		TimingReport::Activation activation(&report);
+		AssemblyPointer sub = make_shared<Assembly>();
+		AssemblyItem unreachable = sub->newTag();
+		AssemblyItem target = sub->newTag();
+		sub->append(u256(0));
+		sub->append(unreachable.pushTag());
+		sub->append(Instruction::MUL);
+		sub->append(u256(0));
+		sub->append(Instruction::SSTORE);
+		sub->append(target.pushTag());
+		sub->append(Instruction::JUMP);
+		sub->append(unreachable);
+		sub->append(_unreachableValue);
+		sub->append(u256(0));
+		sub->append(Instruction::SSTORE);
+		sub->append(Instruction::STOP);
+		sub->append(target);
+		sub->append(u256(1));
+		sub->append(Instruction::SLOAD);
+		sub->append(u256(2));
+		sub->append(Instruction::SSTORE);
+		sub->append(Instruction::STOP);
+
+		Assembly::OptimiserSettings settings;
+		settings.runJumpdestRemover = true;
+		settings.runPeephole = true;
+		settings.runCSE = true;
+		AssemblyItems items = optimiseSubAssembly(sub, settings);
+		_skippedBlocks = counter(report, "optimiser.cse", "skippedBlocks");
+		return items;
+	};
+
+	AssemblyItems expectation{
+		u256(0), Instruction::DUP1, Instruction::SSTORE,
+		u256(1), Instruction::SLOAD, u256(2), Instruction::SSTORE, Instruction::STOP
+	};
+	size_t skippedBlocks = 0;
+	AssemblyItems items = optimise(Instruction::CALLVALUE, skippedBlocks);
+	BOOST_CHECK_EQUAL_COLLECTIONS(items.begin(), items.end(), expectation.begin(), expectation.end());
+	// The blocks that did not change in the first round are not analysed again.
+	BOOST_CHECK_EQUAL(skippedBlocks, 2);
+
+	// Removing MSIZE changes how the eliminator analyses blocks, so the blocks that did not
+	// change in the first round are analysed again in the second round.
+	items = optimise(Instruction::MSIZE, skippedBlocks);
+	BOOST_CHECK_EQUAL_COLLECTIONS(items.begin(), items.end(), expectation.begin(), expectation.end());
+	BOOST_CHECK_EQUAL(skippedBlocks, 1);
+}
+
 BOOST_AUTO_TEST_CASE(cse_sub_zero)
 {
 	checkCSE({
@@ -36,11 +36,21 @@ BOOST_AUTO_TEST_SUITE(SourceLocationTest)
 BOOST_AUTO_TEST_CASE(test_fail)
 {
 	BOOST_CHECK(SourceLocation() == SourceLocation());
-	BOOST_CHECK(SourceLocation(0, 3, std::make_shared<std::string>("sourceA")) != SourceLocation(0, 3, std::make_shared<std::string>("sourceB")));
-	BOOST_CHECK(SourceLocation(0, 3, std::make_shared<std::string>("source")) == SourceLocation(0, 3, std::make_shared<std::string>("source")));
-	BOOST_CHECK(SourceLocation(3, 7, std::make_shared<std::string>("source")).contains(SourceLocation(4, 6, std::make_shared<std::string>("source"))));
-	BOOST_CHECK(!SourceLocation(3, 7, std::make_shared<std::string>("sourceA")).contains(SourceLocation(4, 6, std::make_shared<std::string>("sourceB"))));
-	BOOST_CHECK(SourceLocation(3, 7, std::make_shared<std::string>("sourceA")) < SourceLocation(4, 6, std::make_shared<std::string>("sourceB")));
+	BOOST_CHECK(SourceLocation(0, 3, internSourceName("sourceA")) != SourceLocation(0, 3, internSourceName("sourceB")));
+	BOOST_CHECK(SourceLocation(0, 3, internSourceName("source")) == SourceLocation(0, 3, internSourceName("source")));
+	BOOST_CHECK(SourceLocation(3, 7, internSourceName("source")).contains(SourceLocation(4, 6, internSourceName("source"))));
+	BOOST_CHECK(!SourceLocation(3, 7, internSourceName("sourceA")).contains(SourceLocation(4, 6, internSourceName("sourceB"))));
+	BOOST_CHECK(SourceLocation(3, 7, internSourceName("sourceA")) < SourceLocation(4, 6, internSourceName("sourceB")));
+}
+
+BOOST_AUTO_TEST_CASE(interned_source_names)
+{
+	std::string name = "source";
+	BOOST_CHECK(internSourceName(name) == internSourceName("source"));
+	BOOST_CHECK(internSourceName("source") != internSourceName("sourceA"));
+	BOOST_CHECK_EQUAL(*internSourceName("sourceA"), "sourceA");
+	BOOST_CHECK(SourceLocation(4, 6, internSourceName("sourceB")) < SourceLocation(3, 7, internSourceName("sourceC")));
+	BOOST_CHECK(SourceLocation(4, 6, nullptr) < SourceLocation(3, 7, internSourceName("sourceA")));
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -23,6 +23,8 @@
 #include <tuple>
 #include <boost/test/unit_test.hpp>
 #include <libsolidity/interface/Exceptions.h>
+#include <libsolidity/ast/Types.h>
+#include <libsolidity/codegen/ABIFunctions.h>
 #include <test/libsolidity/SolidityExecutionFramework.h>
 
 #include <test/libsolidity/ABITestsCommon.h>
@@ -508,6 +510,50 @@ BOOST_AUTO_TEST_CASE(structs2)
 
 BOOST_AUTO_TEST_SUITE_END()
 
+// Does not execute code, so it is not part of the suite above, which requires IPC.
+BOOST_AUTO_TEST_SUITE(ABIFunctionsTest)
+
+BOOST_AUTO_TEST_CASE(abi_functions_cache)
+{
+	TypePointer uintType = make_shared<IntegerType>(256);
+	TypePointers types{
+		make_shared<ArrayType>(DataLocation::Memory, uintType),
+		make_shared<ArrayType>(DataLocation::Memory, make_shared<ArrayType>(DataLocation::Memory, uintType))
+	};
+	auto cache = make_shared<ABIFunctionCache>();
+	EVMVersion evmVersion = dev::test::Options::get().evmVersion();
+
+	ABIFunctions uncached(evmVersion);
+	string encoder = uncached.tupleEncoder(types, types);
+	string decoder = uncached.tupleDecoder(types, true);
+	string expectation = uncached.requestedFunctions();
+
+	// The first user fills the cache, the others take the functions and the
+	// functions they use from it.
+	for (size_t i = 0; i < 3; ++i)
+	{
+		ABIFunctions functions(evmVersion, cache);
+		BOOST_CHECK_EQUAL(functions.tupleEncoder(types, types), encoder);
+		BOOST_CHECK_EQUAL(functions.tupleDecoder(types, true), decoder);
+		BOOST_CHECK_EQUAL(functions.requestedFunctions(), expectation);
+		BOOST_CHECK(!!cache->lookup(encoder, evmVersion));
+		BOOST_CHECK(!!cache->lookup(decoder, evmVersion));
+	}
+
+	// Functions that were requested before are not added again with a cached function using them.
+	ABIFunctions functions(evmVersion, cache);
+	uncached.tupleEncoder({types[1]}, {types[1]});
+	uncached.tupleEncoder(types, types);
+	functions.tupleEncoder({types[1]}, {types[1]});
+	functions.tupleEncoder(types, types);
+	BOOST_CHECK_EQUAL(functions.requestedFunctions(), uncached.requestedFunctions());
+
+	// Functions are cached per EVM version.
+	BOOST_CHECK(!cache->lookup(encoder, EVMVersion::homestead()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 }
 }
 } // end namespaces
@@ -348,6 +348,83 @@ BOOST_AUTO_TEST_CASE(complex_control_flow)
 	testRunTimeGas("ln(int128)", vector<bytes>{encodeArgs(0), encodeArgs(10), encodeArgs(105), encodeArgs(30000)});
 }
 
+BOOST_AUTO_TEST_CASE(repeated_internal_function_calls)
+{
+	// Calling the same internal function twice on a path used to be treated
+	// as a backwards jump. Such calls are now estimated using a summary of the function.
+	// Both calls write to fresh storage slots for large arguments, so that the estimated
+	// maximum is reached by the last argument variant.
+	char const* sourceCode = R"(
+		contract test {
+			mapping(uint => uint) data;
+			function f(uint x) public returns (uint) {
+				return g(x) + g(x + 1);
+			}
+			function g(uint x) internal returns (uint) {
+				if (x > 7)
+					data[x] = x;
+				return data[x];
+			}
+		}
+	)";
+	testCreationTimeGas(sourceCode);
+	testRunTimeGas("f(uint256)", vector<bytes>{encodeArgs(2), encodeArgs(7), encodeArgs(100)});
+	Json::Value estimates = m_compiler.gasEstimates(m_compiler.lastContractName());
+	BOOST_CHECK(estimates["external"]["f(uint256)"].asString() != "infinite");
+	BOOST_CHECK(estimates["internal"]["g(uint256)"].asString() != "infinite");
+}
+
+BOOST_AUTO_TEST_CASE(exploration_budget)
+{
+	char const* sourceCode = R"(
+		contract test {
+			uint data;
+			function f(uint x) public {
+				if (x > 7)
+					data = x;
+			}
+		}
+	)";
+	compile(sourceCode);
+	AssemblyItems const& items = *m_compiler.runtimeAssemblyItems(m_compiler.lastContractName());
+	EVMVersion evmVersion = dev::test::Options::get().evmVersion();
+	BOOST_CHECK(!PathGasMeter(items, evmVersion).estimateMax(0, make_shared<KnownState>()).isInfinite);
+	BOOST_CHECK(PathGasMeter(items, evmVersion, nullptr, 10).estimateMax(0, make_shared<KnownState>()).isInfinite);
+}
+
+BOOST_AUTO_TEST_CASE(exploration_budget_includes_function_summaries)
+{
+	// Calls the function at tag 3, which adds a storage value to its argument, twice.
+	AssemblyItems items{
+		AssemblyItem(PushTag, 1), u256(5), AssemblyItem(PushTag, 3), Instruction::JUMP,
+		AssemblyItem(Tag, 1), AssemblyItem(PushTag, 2), u256(6), AssemblyItem(PushTag, 3), Instruction::JUMP,
+		AssemblyItem(Tag, 2), Instruction::STOP,
+		AssemblyItem(Tag, 3), Instruction::DUP1, Instruction::SLOAD, Instruction::ADD, Instruction::SWAP1, Instruction::JUMP
+	};
+	EVMVersion evmVersion = dev::test::Options::get().evmVersion();
+	auto estimate = [&](FunctionGasSummaries& _functions, size_t _budget)
+	{
+		return PathGasMeter(items, evmVersion, &_functions, _budget).estimateMax(0, make_shared<KnownState>());
+	};
+	auto smallestBudget = [&](bool _cachedSummaries) -> size_t
+	{
+		for (size_t budget = 1; budget < 100; ++budget)
+		{
+			FunctionGasSummaries functions(items);
+			functions.registerFunction(3, 1);
+			if (_cachedSummaries)
+				BOOST_REQUIRE(!estimate(functions, PathGasMeter::defaultExplorationBudget).isInfinite);
+			if (!estimate(functions, budget).isInfinite)
+				return budget;
+		}
+		return 0;
+	};
+	// The eleven items outside of the function and its six items for both calls.
+	BOOST_CHECK_EQUAL(smallestBudget(false), 23);
+	// Summaries taken from the cache count the same.
+	BOOST_CHECK_EQUAL(smallestBudget(true), 23);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
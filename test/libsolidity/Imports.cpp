@@ -25,6 +25,7 @@
 
 #include <libsolidity/interface/Exceptions.h>
 #include <libsolidity/interface/CompilerStack.h>
+#include <libsolidity/ast/AST.h>
 
 #include <boost/test/unit_test.hpp>
 
@@ -320,6 +321,66 @@ BOOST_AUTO_TEST_CASE(shadowing_builtins_with_alias)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(incremental_parsing)
+{
+	string const sourceA = "contract C { function f() public pure returns (uint) { return 1; } } pragma solidity >=0.0;";
+	string const sourceB = "import \"a\"; contract D is C { function g() public pure returns (uint) { return f() + 2; } } pragma solidity >=0.0;";
+	string const changedSourceB = "import \"a\"; contract D is C { function g() public pure returns (uint) { return f() + 3; } } pragma solidity >=0.0;";
+	auto bytecodeOf = [](string const& _sourceA, string const& _sourceB)
+	{
+		CompilerStack c;
+		c.addSource("a", _sourceA);
+		c.addSource("b", _sourceB);
+		c.setEVMVersion(dev::test::Options::get().evmVersion());
+		BOOST_REQUIRE(c.compile());
+		return c.object("b:D").bytecode;
+	};
+	auto idOfFresh = [](string const& _sourceA, string const& _sourceB)
+	{
+		CompilerStack c;
+		c.addSource("a", _sourceA);
+		c.addSource("b", _sourceB);
+		c.setEVMVersion(dev::test::Options::get().evmVersion());
+		BOOST_REQUIRE(c.parse());
+		return make_pair(c.ast("a").id(), c.ast("b").id());
+	};
+
+	CompilerStack c;
+	c.useIncrementalParsing(true);
+	c.addSource("a", sourceA);
+	c.addSource("b", sourceB);
+	c.setEVMVersion(dev::test::Options::get().evmVersion());
+	BOOST_REQUIRE(c.compile());
+	size_t idOfA = c.ast("a").id();
+
+	c.addSource("b", changedSourceB);
+	c.setEVMVersion(dev::test::Options::get().evmVersion());
+	BOOST_REQUIRE(c.compile());
+	BOOST_CHECK_EQUAL(c.ast("a").id(), idOfA);
+	BOOST_CHECK(make_pair(c.ast("a").id(), c.ast("b").id()) == idOfFresh(sourceA, changedSourceB));
+	BOOST_CHECK(c.object("b:D").bytecode == bytecodeOf(sourceA, changedSourceB));
+
+	// The syntax tree of "b" is not reused if "a" has a different number of nodes,
+	// because the IDs must not depend on earlier compilations.
+	string const largerSourceA = "contract E {} contract C { function f() public pure returns (uint) { return 1; } } pragma solidity >=0.0;";
+	c.addSource("a", largerSourceA);
+	c.setEVMVersion(dev::test::Options::get().evmVersion());
+	BOOST_REQUIRE(c.compile());
+	BOOST_CHECK(make_pair(c.ast("a").id(), c.ast("b").id()) == idOfFresh(largerSourceA, changedSourceB));
+	BOOST_CHECK(c.object("b:D").bytecode == bytecodeOf(largerSourceA, changedSourceB));
+
+	// The syntax tree of "b" is reused if "a" keeps its number of nodes and is analysed
+	// again against the new version of "a".
+	string const changedSourceA = "contract E {} contract C { function f() public pure returns (uint) { return 4; } } pragma solidity >=0.0;";
+	SourceUnit const* astOfB = &c.ast("b");
+	c.addSource("a", changedSourceA);
+	c.setEVMVersion(dev::test::Options::get().evmVersion());
+	BOOST_REQUIRE(c.compile());
+	BOOST_CHECK_EQUAL(&c.ast("b"), astOfB);
+	BOOST_CHECK(make_pair(c.ast("a").id(), c.ast("b").id()) == idOfFresh(changedSourceA, changedSourceB));
+	BOOST_CHECK(c.object("b:D").bytecode == bytecodeOf(changedSourceA, changedSourceB));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
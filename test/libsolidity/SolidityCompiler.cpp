@@ -22,6 +22,8 @@
 
 #include <test/Options.h>
 
+#include <libevmasm/Instruction.h>
+
 using namespace std;
 
 namespace dev
@@ -31,6 +33,23 @@ namespace solidity
 namespace test
 {
 
+namespace
+{
+
+/// Compiles @a _sourceCode for @a _evmVersion with the optimiser settings of the test run
+/// and @returns the runtime bytecode of the contract C.
+bytes compileForEVMVersion(CompilerStack& _compiler, string const& _sourceCode, EVMVersion _evmVersion)
+{
+	_compiler.reset();
+	_compiler.addSource("", _sourceCode);
+	_compiler.setEVMVersion(_evmVersion);
+	_compiler.setOptimiserSettings(dev::test::Options::get().optimize);
+	BOOST_REQUIRE_MESSAGE(_compiler.compile(), "Compiling contract failed");
+	return _compiler.runtimeObject("C").bytecode;
+}
+
+}
+
 BOOST_FIXTURE_TEST_SUITE(Compiler, AnalysisFramework)
 
 BOOST_AUTO_TEST_CASE(does_not_include_creation_time_only_internal_functions)
@@ -53,6 +72,78 @@ BOOST_AUTO_TEST_CASE(does_not_include_creation_time_only_internal_functions)
 	BOOST_CHECK(runtimeBytecode.size() <= 70);
 }
 
+BOOST_AUTO_TEST_CASE(packed_storage_access_uses_shifts)
+{
+	char const* sourceCode = R"(
+		pragma solidity >=0.0;
+		contract C {
+			struct S { uint8 a; bytes3 b; uint16 c; }
+			S s;
+			bytes data;
+			function f(uint8 a, uint i) public returns (bytes3, bytes1) {
+				s.a = a;
+				s.b = bytes3(uint24(a));
+				data[i] = bytes1(a);
+				return (s.b, data[i]);
+			}
+		}
+	)";
+	for (EVMVersion evmVersion: {EVMVersion::byzantium(), EVMVersion::constantinople()})
+	{
+		bytes bytecode = compileForEVMVersion(m_compiler, sourceCode, evmVersion);
+		// Do not look at the metadata.
+		size_t metadataSize = (bytecode[bytecode.size() - 2] << 8) + bytecode[bytecode.size() - 1];
+		BOOST_REQUIRE(bytecode.size() >= metadataSize + 2);
+		map<Instruction, size_t> instructions;
+		eachInstruction(bytes(bytecode.begin(), bytecode.end() - metadataSize - 2), [&](Instruction _instr, u256 const&) {
+			instructions[_instr]++;
+		});
+		if (evmVersion.hasBitwiseShifting())
+		{
+			BOOST_CHECK_EQUAL(instructions[Instruction::EXP], 0);
+			BOOST_CHECK(instructions[Instruction::SHL] > 0);
+			BOOST_CHECK(instructions[Instruction::SHR] > 0);
+		}
+		else
+		{
+			BOOST_CHECK(instructions[Instruction::EXP] > 0);
+			BOOST_CHECK_EQUAL(instructions[Instruction::SHL], 0);
+			BOOST_CHECK_EQUAL(instructions[Instruction::SHR], 0);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(repeated_compilation_reuses_inline_assembly)
+{
+	// The inline assembly snippets of the code generator are cached across compilations,
+	// so compiling again, also after compiling for another EVM version, gives the same code.
+	char const* sourceCode = R"(
+		pragma solidity >=0.0;
+		contract C {
+			bytes data;
+			function f(bytes memory x, uint8 a) public returns (bytes memory, bytes1) {
+				data = x;
+				return (abi.encodePacked(x, a), data[a]);
+			}
+		}
+	)";
+	map<string, bytes> bytecodes;
+	for (EVMVersion evmVersion: {
+		EVMVersion::byzantium(),
+		EVMVersion::constantinople(),
+		EVMVersion::byzantium(),
+		EVMVersion::constantinople()
+	})
+	{
+		bytes bytecode = compileForEVMVersion(m_compiler, sourceCode, evmVersion);
+		if (bytecodes.count(evmVersion.name()))
+			BOOST_CHECK(bytecodes[evmVersion.name()] == bytecode);
+		else
+			bytecodes[evmVersion.name()] = bytecode;
+	}
+	BOOST_CHECK(bytecodes["byzantium"] != bytecodes["constantinople"]);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
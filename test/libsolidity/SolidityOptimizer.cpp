@@ -632,6 +632,27 @@ BOOST_AUTO_TEST_CASE(optimise_multi_stores)
 	BOOST_CHECK_EQUAL(numInstructions(m_optimizedBytecode, Instruction::SSTORE), 8);
 }
 
+BOOST_AUTO_TEST_CASE(function_selector_search_tree)
+{
+	// With enough expected runs, the function selector is split into a search tree,
+	// which needs comparisons using GT.
+	string sourceCode = "contract C {\n";
+	for (unsigned i = 0; i < 10; ++i)
+		sourceCode += "function f" + to_string(i) + "(uint a) public pure returns (uint) { return a + " + to_string(i) + "; }\n";
+	sourceCode += "}\n";
+	size_t linearComparisons = numInstructions(
+		compileAndRunWithOptimizer("pragma solidity >=0.0;\n" + sourceCode, 0, "C", true, 1),
+		Instruction::GT
+	);
+	compileBothVersions(sourceCode, 0, "C", 1000000);
+	BOOST_CHECK_EQUAL(numInstructions(m_optimizedBytecode, Instruction::GT), linearComparisons + 3);
+	for (unsigned i = 0; i < 10; ++i)
+	{
+		compareVersions("f" + to_string(i) + "(uint256)", u256(7));
+		BOOST_CHECK(callContractFunction("f" + to_string(i) + "(uint256)", u256(7)) == encodeArgs(u256(7 + i)));
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -616,6 +616,27 @@ BOOST_AUTO_TEST_CASE(irregular_line_breaks_in_strings)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(position_to_line_column)
+{
+	CharStream stream("ab\n\ncd\n");
+	BOOST_CHECK(stream.lineStarts() == vector<size_t>({0, 3, 4, 7}));
+	vector<tuple<int, int>> const expectations{
+		make_tuple(0, 0), make_tuple(0, 1), make_tuple(0, 2),
+		make_tuple(1, 0),
+		make_tuple(2, 0), make_tuple(2, 1), make_tuple(2, 2),
+		make_tuple(3, 0), make_tuple(3, 0)
+	};
+	for (size_t position = 0; position < expectations.size(); ++position)
+		BOOST_CHECK(stream.translatePositionToLineColumn(position) == expectations[position]);
+	BOOST_CHECK(stream.translatePositionToLineColumn(-1) == make_tuple(3, 0));
+	BOOST_CHECK_EQUAL(stream.lineAtPosition(0), "ab");
+	BOOST_CHECK_EQUAL(stream.lineAtPosition(2), "ab");
+	BOOST_CHECK_EQUAL(stream.lineAtPosition(3), "");
+	BOOST_CHECK_EQUAL(stream.lineAtPosition(5), "cd");
+	BOOST_CHECK_EQUAL(stream.lineAtPosition(7), "");
+	BOOST_CHECK(CharStream().translatePositionToLineColumn(5) == make_tuple(0, 0));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
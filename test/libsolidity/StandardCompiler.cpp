@@ -20,8 +20,12 @@
  */
 
 #include <string>
+#include <thread>
 #include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
 #include <libsolidity/interface/StandardCompiler.h>
+#include <libsolidity/interface/ArtifactCache.h>
+#include <libdevcore/CommonIO.h>
 #include <libdevcore/JSON.h>
 
 #include "../Metadata.h"
@@ -604,6 +608,41 @@ BOOST_AUTO_TEST_CASE(output_selection_dependent_contract_with_import)
 	BOOST_CHECK_EQUAL(dev::jsonCompactPrint(contract["abi"]), "[{\"constant\":false,\"inputs\":[],\"name\":\"f\",\"outputs\":[],\"payable\":false,\"stateMutability\":\"nonpayable\",\"type\":\"function\"}]");
 }
 
+BOOST_AUTO_TEST_CASE(output_selection_skips_code_generation)
+{
+	// Code generation fails for B, so this checks that it is only run if needed.
+	string const source =
+		"contract A { function f() public pure returns (uint) { return 1; } } "
+		"contract B { function g(uint a1, uint, uint, uint, uint, uint, uint, uint, uint, uint, uint, uint, uint, uint, uint, uint, uint a17) "
+		"public pure returns (uint) { return a1 + a17; } }";
+	auto compileWithSelection = [&](string const& _selection)
+	{
+		return compile(R"({
+			"language": "Solidity",
+			"settings": { "outputSelection": )" + _selection + R"( },
+			"sources": { "fileA": { "content": ")" + source + R"(" } }
+		})");
+	};
+
+	Json::Value result = compileWithSelection(R"({ "*": { "*": [ "abi", "metadata", "evm.methodIdentifiers" ], "": [ "ast" ] } })");
+	BOOST_CHECK(containsAtMostWarnings(result));
+	BOOST_CHECK(result["sources"]["fileA"]["ast"].isObject());
+	Json::Value contract = getContractResult(result, "fileA", "B");
+	BOOST_CHECK(contract["abi"].isArray());
+	BOOST_CHECK(contract["metadata"].isString());
+	BOOST_CHECK(contract["evm"]["methodIdentifiers"].isObject());
+	BOOST_CHECK(!contract["evm"].isMember("bytecode"));
+
+	result = compileWithSelection(R"({ "*": { "*": [ "abi" ], "A": [ "evm.bytecode.object" ] } })");
+	BOOST_CHECK(containsAtMostWarnings(result));
+	BOOST_CHECK(getContractResult(result, "fileA", "A")["evm"]["bytecode"]["object"].isString());
+	BOOST_CHECK(getContractResult(result, "fileA", "B")["abi"].isArray());
+	BOOST_CHECK(!getContractResult(result, "fileA", "B")["evm"].isMember("bytecode"));
+
+	result = compileWithSelection(R"({ "*": { "*": [ "evm.bytecode.object" ] } })");
+	BOOST_CHECK(!containsAtMostWarnings(result));
+}
+
 BOOST_AUTO_TEST_CASE(filename_with_colon)
 {
 	char const* input = R"(
@@ -860,6 +899,279 @@ BOOST_AUTO_TEST_CASE(evm_version)
 	BOOST_CHECK(result["errors"][0]["message"].asString() == "Invalid EVM version requested.");
 }
 
+BOOST_AUTO_TEST_CASE(parallelism)
+{
+	auto inputForParallelism = [](string const& _parallelism)
+	{
+		return R"(
+			{
+				"language": "Solidity",
+				"sources": {
+					"fileA": { "content": "contract A { function f() public pure returns (uint) { return 7; } }" },
+					"fileB": { "content": "import \"fileA\"; contract B { function f() public returns (A) { return new A(); } }" },
+					"fileC": { "content": "import \"fileA\"; contract C { function f() public returns (A) { return new A(); } }" },
+					"fileD": { "content": "import \"fileB\"; import \"fileC\"; contract D { B b = new B(); C c = new C(); }" }
+				},
+				"settings": {
+					)" + _parallelism + R"(
+					"optimizer": { "enabled": true },
+					"outputSelection": {
+						"*": {
+							"*": [ "evm.bytecode", "evm.deployedBytecode", "metadata" ]
+						}
+					}
+				}
+			}
+		)";
+	};
+	Json::Value serial = compile(inputForParallelism(""));
+	BOOST_CHECK(containsAtMostWarnings(serial));
+	for (string const& parallelism: {"0", "1", "2", "8"})
+	{
+		Json::Value result = compile(inputForParallelism("\"parallelism\": " + parallelism + ","));
+		BOOST_CHECK(containsAtMostWarnings(result));
+		BOOST_CHECK_EQUAL(jsonCompactPrint(result["contracts"]), jsonCompactPrint(serial["contracts"]));
+	}
+	Json::Value result = compile(inputForParallelism("\"parallelism\": \"many\","));
+	BOOST_CHECK(containsError(result, "JSONError", "The \"parallelism\" setting must be an unsigned number."));
+}
+
+BOOST_AUTO_TEST_CASE(optimizer_control_flow)
+{
+	auto inputForControlFlow = [](string const& _controlFlow)
+	{
+		return R"(
+			{
+				"language": "Solidity",
+				"sources": {
+					"fileA": { "content": "contract A { uint x; function f(uint a) public returns (uint) { if (a > x) x = a; return x; } }" }
+				},
+				"settings": {
+					"optimizer": { "enabled": true )" + _controlFlow + R"( },
+					"outputSelection": { "*": { "*": [ "evm.deployedBytecode.object", "metadata" ] } }
+				}
+			}
+		)";
+	};
+	Json::Value result = compile(inputForControlFlow(""));
+	BOOST_CHECK(containsAtMostWarnings(result));
+	BOOST_CHECK(result["contracts"]["fileA"]["A"]["metadata"].asString().find("controlFlow") == string::npos);
+	result = compile(inputForControlFlow(", \"controlFlow\": true"));
+	BOOST_CHECK(containsAtMostWarnings(result));
+	BOOST_CHECK(result["contracts"]["fileA"]["A"]["metadata"].asString().find("\"controlFlow\":true") != string::npos);
+	result = compile(inputForControlFlow(", \"controlFlow\": 1"));
+	BOOST_CHECK(containsError(result, "JSONError", "The \"controlFlow\" setting must be a boolean."));
+}
+
+BOOST_AUTO_TEST_CASE(timing_report)
+{
+	char const* input = R"(
+	{
+		"language": "Solidity",
+		"sources": {
+			"fileA": { "content": "contract A { function f() public pure returns (uint) { return 1 + 2; } }" }
+		},
+		"settings": {
+			"optimizer": { "enabled": true },
+			"parallelism": 2,
+			"debug": { "timing": true },
+			"outputSelection": { "*": { "*": [ "evm.bytecode.object" ] } }
+		}
+	}
+	)";
+	Json::Value result = compile(input);
+	BOOST_CHECK(containsAtMostWarnings(result));
+	Json::Value const& timing = result["debug"]["timing"];
+	BOOST_REQUIRE(timing.isObject());
+	BOOST_CHECK_EQUAL(timing["total"][""]["calls"].asUInt(), 1);
+	BOOST_CHECK_EQUAL(timing["parsing"]["fileA"]["calls"].asUInt(), 1);
+	BOOST_CHECK_EQUAL(timing["typeChecking"]["fileA:A"]["calls"].asUInt(), 1);
+	BOOST_CHECK_EQUAL(timing["codeGeneration"]["fileA:A"]["calls"].asUInt(), 1);
+	BOOST_CHECK(timing["optimiser.peephole"]["fileA:A"]["calls"].asUInt() > 0);
+	BOOST_CHECK(timing["optimiser.cse"]["fileA:A"]["counters"]["changes"].asUInt() > 0);
+	BOOST_CHECK(timing["assembly"]["fileA:A"]["seconds"].isDouble());
+
+	result = compile(R"({ "language": "Solidity", "sources": { "fileA": { "content": "" } }, "settings": { "debug": { "timing": 1 } } })");
+	BOOST_CHECK(containsError(result, "JSONError", "The \"timing\" setting must be a boolean."));
+	result = compile(R"({ "language": "Solidity", "sources": { "fileA": { "content": "" } }, "settings": { } })");
+	BOOST_CHECK(!result.isMember("debug"));
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_compilations)
+{
+	char const* input = R"(
+		{
+			"language": "Solidity",
+			"sources": {
+				"fileA": { "content": "contract A { function f(uint x) public pure returns (uint r) { assembly { r := mul(x, 7) } } }" },
+				"fileB": { "content": "import \"fileA\"; contract B is A { event E(uint); function g() public returns (A) { emit E(f(2)); return new A(); } }" }
+			},
+			"settings": {
+				"optimizer": { "enabled": true },
+				"outputSelection": {
+					"*": {
+						"*": [ "*" ],
+						"": [ "ast", "legacyAST" ]
+					}
+				}
+			}
+		}
+	)";
+	string const expectation = jsonCompactPrint(compile(input));
+	BOOST_CHECK(containsAtMostWarnings(compile(input)));
+
+	// Boost.Test assertions are not thread-safe, so the results are only compared afterwards.
+	size_t const threadCount = 8;
+	size_t const compilationsPerThread = 4;
+	vector<vector<string>> results(threadCount);
+	vector<thread> threads;
+	for (size_t i = 0; i < threadCount; ++i)
+		threads.emplace_back([&, i]()
+		{
+			for (size_t j = 0; j < compilationsPerThread; ++j)
+				results[i].push_back(jsonCompactPrint(compile(input)));
+		});
+	for (auto& t: threads)
+		t.join();
+
+	for (auto const& threadResults: results)
+	{
+		BOOST_REQUIRE_EQUAL(threadResults.size(), compilationsPerThread);
+		for (string const& result: threadResults)
+			BOOST_CHECK(result == expectation);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(artifact_cache)
+{
+	auto inputWithSources = [](string const& _sources)
+	{
+		return R"(
+			{
+				"language": "Solidity",
+				"sources": {
+					)" + _sources + R"(
+					"fileB": { "content": "import \"fileA\"; contract B { function f() public returns (A) { return new A(); } }" }
+				},
+				"settings": {
+					"optimizer": { "enabled": true },
+					"outputSelection": {
+						"*": {
+							"*": [ "evm.bytecode", "evm.deployedBytecode", "evm.assembly", "evm.gasEstimates", "metadata" ]
+						}
+					}
+				}
+			}
+		)";
+	};
+	string const directory = (
+		boost::filesystem::temp_directory_path() /
+		boost::filesystem::unique_path("solc-artifact-cache-%%%%-%%%%-%%%%")
+	).string();
+	auto compileCached = [&](string const& _input)
+	{
+		solidity::StandardCompiler compiler;
+		compiler.setArtifactCache(make_shared<ArtifactCache>(directory));
+		Json::Value ret;
+		BOOST_REQUIRE(jsonParseStrict(compiler.compile(_input), ret));
+		return ret;
+	};
+	auto cacheEntries = [&]()
+	{
+		return distance(boost::filesystem::directory_iterator(directory), boost::filesystem::directory_iterator());
+	};
+
+	string const contractA = R"("fileA": { "content": "contract A { function f() public pure returns (uint) { return 7; } }" },)";
+	string input = inputWithSources(contractA);
+	Json::Value expectation = compile(input);
+	BOOST_CHECK(containsAtMostWarnings(expectation));
+	BOOST_CHECK_EQUAL(jsonCompactPrint(compileCached(input)), jsonCompactPrint(expectation));
+	BOOST_CHECK_EQUAL(cacheEntries(), 2);
+	// Loaded from the cache, the code is only generated for the assembly and the gas estimates.
+	BOOST_CHECK_EQUAL(jsonCompactPrint(compileCached(input)), jsonCompactPrint(expectation));
+	BOOST_CHECK_EQUAL(cacheEntries(), 2);
+
+	// An unrelated source changes the indices used in the source mappings.
+	input = inputWithSources(R"("file0": { "content": "contract C {}" },)" + contractA);
+	BOOST_CHECK_EQUAL(jsonCompactPrint(compileCached(input)), jsonCompactPrint(compile(input)));
+	BOOST_CHECK_EQUAL(cacheEntries(), 3);
+
+	// Changing a source invalidates all contracts that depend on it.
+	input = inputWithSources(R"("fileA": { "content": "contract A { function f() public pure returns (uint) { return 8; } }" },)");
+	BOOST_CHECK_EQUAL(jsonCompactPrint(compileCached(input)), jsonCompactPrint(compile(input)));
+	BOOST_CHECK_EQUAL(cacheEntries(), 5);
+
+	boost::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_CASE(artifact_cache_corrupt_entries)
+{
+	string const input = R"(
+		{
+			"language": "Solidity",
+			"sources": {
+				"fileA": { "content": "contract A { function f() public pure returns (uint) { return 7; } }" }
+			},
+			"settings": {
+				"outputSelection": {
+					"*": { "*": [ "evm.bytecode", "evm.deployedBytecode" ] }
+				}
+			}
+		}
+	)";
+	string const directory = (
+		boost::filesystem::temp_directory_path() /
+		boost::filesystem::unique_path("solc-artifact-cache-%%%%-%%%%-%%%%")
+	).string();
+	auto compileCached = [&]()
+	{
+		solidity::StandardCompiler compiler;
+		compiler.setArtifactCache(make_shared<ArtifactCache>(directory));
+		return compiler.compile(input);
+	};
+	string const expectation = jsonCompactPrint(compile(input));
+	BOOST_CHECK_EQUAL(compileCached(), expectation);
+
+	// Corrupt entries are treated as missing and replaced.
+	auto corruptEntries = [&](function<void(Json::Value&)> const& _corrupt)
+	{
+		for (auto const& file: boost::filesystem::directory_iterator(directory))
+		{
+			Json::Value entry;
+			BOOST_REQUIRE(jsonParseStrict(readFileAsString(file.path().string()), entry));
+			_corrupt(entry);
+			writeFile(file.path().string(), jsonCompactPrint(entry));
+		}
+	};
+	vector<function<void(Json::Value&)>> corruptions{
+		[](Json::Value& _entry) { _entry["deployedBytecode"]["object"] = "60zz"; },
+		[](Json::Value& _entry) { _entry["deployedBytecode"]["object"] = ""; },
+		[](Json::Value& _entry) { _entry["deployedBytecode"]["linkReferences"]["100000"] = "L"; },
+		[](Json::Value& _entry) { _entry["deployedBytecode"]["linkReferences"]["100000000000000000000000000000"] = "L"; },
+		[](Json::Value& _entry) { _entry["deployedSourceMap"] = "0:1:100000000000000000000000000000:-"; }
+	};
+	for (auto const& corrupt: corruptions)
+	{
+		corruptEntries(corrupt);
+		BOOST_CHECK_EQUAL(compileCached(), expectation);
+	}
+
+	boost::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_CASE(artifact_cache_in_memory_is_bounded)
+{
+	ArtifactCache cache(string(), 2);
+	Json::Value entry(Json::objectValue);
+	for (unsigned i = 1; i <= 3; ++i)
+	{
+		entry["i"] = i;
+		cache.store(h256(i), entry);
+	}
+	BOOST_CHECK(cache.load(h256(1)).isNull());
+	BOOST_CHECK_EQUAL(cache.load(h256(2))["i"].asUInt(), 2);
+	BOOST_CHECK_EQUAL(cache.load(h256(3))["i"].asUInt(), 3);
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 